@@ -2,7 +2,10 @@ TEMPLATE = subdirs
 CONFIG+=ordered
 SUBDIRS = \
     ScorePredictorClient \
-    ScorePredictorServer
+    ScorePredictorServer \
+    ScorePredictorServerHeadless \
+    ScorePredictorLoadGen \
+    ScorePredictorBenchmarks
 
 app.depends = src
 tests.depends = src
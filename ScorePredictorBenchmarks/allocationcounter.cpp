@@ -0,0 +1,69 @@
+#include "allocationcounter.h"
+#include <QAtomicInteger>
+#include <cstdlib>
+#include <new>
+
+// Every allocation of the benchmark binary goes through these replacements of the global operators.
+static QAtomicInteger<quint64> allocations(0);
+
+quint64 AllocationCounter::getAllocations()
+{
+    return allocations.load();
+}
+
+void * operator new(std::size_t size)
+{
+    allocations.fetchAndAddRelaxed(1);
+    void * memory = std::malloc(size == 0 ? 1 : size);
+
+    if(!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void * operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    allocations.fetchAndAddRelaxed(1);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void * memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void * memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void * memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void * memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void * memory, const std::nothrow_t &) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void * memory, const std::nothrow_t &) noexcept
+{
+    std::free(memory);
+}
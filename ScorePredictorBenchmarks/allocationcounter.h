@@ -0,0 +1,12 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+class AllocationCounter
+{
+public:
+    static quint64 getAllocations();
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,173 @@
+#include "benchmarkdatabase.h"
+#include <QStringList>
+#include <QVariant>
+#include <QDateTime>
+
+bool BenchmarkDatabase::execAll(QSqlDatabase database, const QStringList & statements)
+{
+    QSqlQuery query(database);
+
+    for(auto statement : statements)
+    {
+        if(!query.exec(statement))
+            return false;
+    }
+
+    return true;
+}
+
+bool BenchmarkDatabase::createSchema(QSqlDatabase database)
+{
+    // The same tables, indexes and triggers as data/database.db ships with.
+    QStringList statements;
+    statements << "CREATE TABLE user (id INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE NOT NULL, "
+                  "nickname VARCHAR (30) NOT NULL UNIQUE, password VARCHAR (255) NOT NULL)"
+               << "CREATE TABLE tournament_participant (id INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE NOT NULL, "
+                  "tournament_id INTEGER NOT NULL REFERENCES tournament (id), "
+                  "user_id INTEGER NOT NULL REFERENCES user (id))"
+               << "CREATE TABLE round (id INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE NOT NULL, "
+                  "tournament_id INTEGER REFERENCES tournament (id) NOT NULL, name VARCHAR (30) NOT NULL, "
+                  "number INTEGER NOT NULL)"
+               << "CREATE TABLE match_prediction (id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL UNIQUE, "
+                  "match_id INTEGER REFERENCES \"match\" (id) NOT NULL, "
+                  "tournament_participant_id INTEGER REFERENCES tournament_participant (id) NOT NULL, "
+                  "competitor_1_score_prediction INTEGER NOT NULL, competitor_2_score_prediction INTEGER NOT NULL)"
+               << "CREATE TABLE \"match\" (id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL UNIQUE, "
+                  "round_id REFERENCES round (id) NOT NULL, competitor_1 VARCHAR (30) NOT NULL, "
+                  "competitor_1_score INTEGER NOT NULL DEFAULT (0), competitor_2 VARCHAR (30) NOT NULL, "
+                  "competitor_2_score INTEGER NOT NULL DEFAULT (0), predictions_end_time DATETIME NOT NULL)"
+               << "CREATE TABLE user_profile (id INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE NOT NULL, "
+                  "description TEXT DEFAULT ('Description...'), "
+                  "avatar_path VARCHAR (255) DEFAULT ('avatars/default_avatar.png'), "
+                  "user_id INTEGER NOT NULL UNIQUE REFERENCES user (id))"
+               << "CREATE TABLE tournament (id INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE NOT NULL, "
+                  "name VARCHAR (30) NOT NULL ON CONFLICT ROLLBACK, "
+                  "host_user_id INTEGER NOT NULL REFERENCES user (id), password VARCHAR (255), "
+                  "entries_end_time DATETIME NOT NULL, predictors_limit INTEGER NOT NULL, opened BOOLEAN NOT NULL)"
+               << "CREATE INDEX tournament_participant_tournament_id_user_id "
+                  "ON tournament_participant (tournament_id, user_id)"
+               << "CREATE INDEX round_tournament_id ON round (tournament_id)"
+               << "CREATE INDEX user_profile_nickname ON user (nickname)"
+               << "CREATE INDEX match_prediction_match_id_tournament_participant_id "
+                  "ON match_prediction (match_id, tournament_participant_id DESC)"
+               << "CREATE INDEX match_round_id_competitor_1_competitor_2 "
+                  "ON \"match\" (round_id, competitor_1, competitor_2)"
+               << "CREATE INDEX tournament_host_user_id_entries_end_time_name "
+                  "ON tournament (host_user_id, name, entries_end_time)"
+               << "CREATE TRIGGER create_user_profile AFTER INSERT ON user "
+                  "BEGIN INSERT INTO user_profile (user_id) VALUES (new.id); END"
+               << "CREATE TRIGGER create_tournament_participant AFTER INSERT ON tournament "
+                  "BEGIN INSERT INTO tournament_participant (tournament_id, user_id) "
+                  "VALUES (new.id, new.host_user_id); END"
+               << "CREATE TRIGGER delete_from_match_prediction AFTER DELETE ON \"match\" FOR EACH ROW "
+                  "BEGIN DELETE FROM match_prediction WHERE match_prediction.match_id = old.id; END";
+
+    return execAll(database, statements);
+}
+
+unsigned int BenchmarkDatabase::addUser(QSqlDatabase database, const QString & nickname, const QString & password)
+{
+    QSqlQuery query(database);
+    query.prepare("INSERT INTO user (nickname, password) VALUES (:nickname, :password)");
+    query.bindValue(":nickname", nickname);
+    query.bindValue(":password", password);
+
+    return insert(query);
+}
+
+unsigned int BenchmarkDatabase::addOpenRound(QSqlDatabase database, unsigned int hostId,
+                                             const QList<unsigned int> & predictorIds, int numberOfMatches,
+                                             QList<unsigned int> & matchIds)
+{
+    QSqlQuery query(database);
+    database.transaction();
+
+    // Entries are closed but every match still takes predictions, so predictions can be updated at any time.
+    query.prepare("INSERT INTO tournament (name, host_user_id, password, entries_end_time, predictors_limit, opened) "
+                  "VALUES ('Benchmark', :hostId, '', '2000-01-01 00:00:00', :predictorsLimit, 1)");
+    query.bindValue(":hostId", hostId);
+    query.bindValue(":predictorsLimit", predictorIds.size() + 1);
+    unsigned int tournamentId = insert(query);
+
+    query.prepare("INSERT INTO round (tournament_id, name, number) VALUES (:tournamentId, 'Benchmark', 1)");
+    query.bindValue(":tournamentId", tournamentId);
+    unsigned int roundId = insert(query);
+
+    QList<unsigned int> participantIds;
+
+    for(auto predictorId : predictorIds)
+    {
+        query.prepare("INSERT INTO tournament_participant (tournament_id, user_id) VALUES (:tournamentId, :userId)");
+        query.bindValue(":tournamentId", tournamentId);
+        query.bindValue(":userId", predictorId);
+        participantIds << insert(query);
+    }
+
+    for(int i=0; i<numberOfMatches; i++)
+    {
+        query.prepare("INSERT INTO match (round_id, competitor_1, competitor_2, predictions_end_time) "
+                      "VALUES (:roundId, :firstCompetitor, :secondCompetitor, '2099-01-01 20:45:00')");
+        query.bindValue(":roundId", roundId);
+        query.bindValue(":firstCompetitor", QString("Competitor %1").arg(i * 2));
+        query.bindValue(":secondCompetitor", QString("Competitor %1").arg(i * 2 + 1));
+        matchIds << insert(query);
+
+        for(auto participantId : participantIds)
+        {
+            query.prepare("INSERT INTO match_prediction (match_id, tournament_participant_id, "
+                          "competitor_1_score_prediction, competitor_2_score_prediction) "
+                          "VALUES (:matchId, :participantId, 0, 0)");
+            query.bindValue(":matchId", matchIds.last());
+            query.bindValue(":participantId", participantId);
+            insert(query);
+        }
+    }
+
+    if(!database.commit())
+        return 0;
+
+    return roundId;
+}
+
+bool BenchmarkDatabase::addTournaments(QSqlDatabase database, const QList<unsigned int> & hostIds,
+                                       int numberOfTournaments)
+{
+    QStringList words;
+    words << "Premier" << "Champions" << "World" << "Euro" << "Super" << "Winter" << "Summer" << "Junior"
+          << "League" << "Cup" << "Series" << "Open" << "Masters" << "Derby" << "Trophy" << "Classic";
+
+    QSqlQuery query(database);
+    QDateTime entriesEndTime = QDateTime::currentDateTime().addDays(1);
+
+    if(!database.transaction())
+        return false;
+
+    query.prepare("INSERT INTO tournament (name, host_user_id, password, entries_end_time, predictors_limit, opened) "
+                  "VALUES (:name, :hostId, :password, :entriesEndTime, 100, 1)");
+
+    // Common words in every name and a unique number, so searches range from most of the table to a single row.
+    for(int i=0; i<numberOfTournaments; i++)
+    {
+        query.bindValue(":name", QString("%1 %2 %3").arg(words.at(i % words.size()))
+                                                    .arg(words.at(i / words.size() % words.size())).arg(i));
+        query.bindValue(":hostId", hostIds.at(i % hostIds.size()));
+        query.bindValue(":password", i % 10 == 0 ? QString("password") : QString(""));
+        query.bindValue(":entriesEndTime", entriesEndTime.addSecs(i));
+
+        if(!query.exec())
+        {
+            database.rollback();
+            return false;
+        }
+    }
+
+    return database.commit();
+}
+
+unsigned int BenchmarkDatabase::insert(QSqlQuery & query)
+{
+    if(!query.exec())
+        return 0;
+
+    return query.lastInsertId().toUInt();
+}
@@ -0,0 +1,24 @@
+#ifndef BENCHMARKDATABASE_H
+#define BENCHMARKDATABASE_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QList>
+
+class BenchmarkDatabase
+{
+private:
+    static bool execAll(QSqlDatabase database, const QStringList & statements);
+    static unsigned int insert(QSqlQuery & query);
+
+public:
+    static bool createSchema(QSqlDatabase database);
+    static unsigned int addUser(QSqlDatabase database, const QString & nickname, const QString & password);
+    static unsigned int addOpenRound(QSqlDatabase database, unsigned int hostId,
+                                     const QList<unsigned int> & predictorIds, int numberOfMatches,
+                                     QList<unsigned int> & matchIds);
+    static bool addTournaments(QSqlDatabase database, const QList<unsigned int> & hostIds, int numberOfTournaments);
+};
+
+#endif // BENCHMARKDATABASE_H
@@ -0,0 +1,580 @@
+#include "serverbenchmarks.h"
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QSqlDatabase>
+#include <benchmarkdatabase.h>
+#include <allocationcounter.h>
+#include <connectionsload.h>
+#include <packet.h>
+#include <packetbuffer.h>
+#include <tcpserver.h>
+#include <query.h>
+
+ServerBenchmarks::ServerBenchmarks(QObject * parent) : QObject(parent)
+{
+    connectionsPool = nullptr;
+    searcherId = 0;
+}
+
+void ServerBenchmarks::initTestCase()
+{
+    dbConnection = QSharedPointer<DbConnection>(new DbConnection());
+    QVERIFY(dbConnection->connect("Benchmark", ":memory:"));
+    QVERIFY(BenchmarkDatabase::createSchema(dbConnection->getConnection()));
+    QVERIFY(BenchmarkDatabase::addUser(dbConnection->getConnection(), "benchmark", "password") > 0);
+
+    leaderboards = QSharedPointer<LeaderboardEngine>(new LeaderboardEngine());
+    tournamentSearch = QSharedPointer<TournamentSearchIndex>(new TournamentSearchIndex());
+    avatars = QSharedPointer<AvatarStore>(new AvatarStore());
+    responses = QSharedPointer<ResponseCache>(new ResponseCache());
+
+    // Replies are queued to the pool like on the server; no connection has this id, so delivering them drops them.
+    connectionsPool = new TcpConnections(QSharedPointer<ConnectionsLoad>(new ConnectionsLoad()), nullptr,
+                                         QSharedPointer<StartingMessage>(), this);
+    replyChannel = QSharedPointer<ReplyChannel>(new ReplyChannel(connectionsPool, 0));
+}
+
+void ServerBenchmarks::cleanupTestCase()
+{
+    replyChannel.reset();
+    dbConnection->close();
+
+    if(searchConnection)
+        searchConnection->close();
+}
+
+Server::PacketProcessor * ServerBenchmarks::createPacketProcessor()
+{
+    return new Server::PacketProcessor(dbConnection, leaderboards, tournamentSearch, avatars, responses);
+}
+
+void ServerBenchmarks::deliverReplies()
+{
+    QCoreApplication::sendPostedEvents(connectionsPool);
+}
+
+void ServerBenchmarks::processRequestWithProcessorPerPacket()
+{
+    Packet packet(QVariantList() << Packet::ID_LOGIN << QString("benchmark") << QString("password"));
+
+    // How every packet used to be handled: a processor allocated, used once and deleted later.
+    QBENCHMARK
+    {
+        Server::PacketProcessor * packetProcessor = createPacketProcessor();
+        packetProcessor->processRequest(packet, replyChannel);
+        packetProcessor->deleteLater();
+
+        deliverReplies();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+}
+
+void ServerBenchmarks::processRequestWithPersistentProcessor()
+{
+    Packet packet(QVariantList() << Packet::ID_LOGIN << QString("benchmark") << QString("password"));
+    QScopedPointer<Server::PacketProcessor> packetProcessor(createPacketProcessor());
+
+    QBENCHMARK
+    {
+        packetProcessor->processRequest(packet, replyChannel);
+        deliverReplies();
+    }
+
+    // Not timed: whatever a processor allocates to be constructed must not be allocated again for every request.
+    quint64 allocations = AllocationCounter::getAllocations();
+    QScopedPointer<Server::PacketProcessor> constructedProcessor(createPacketProcessor());
+    quint64 processorAllocations = AllocationCounter::getAllocations() - allocations;
+
+    allocations = AllocationCounter::getAllocations();
+    packetProcessor->processRequest(packet, replyChannel);
+    deliverReplies();
+    quint64 persistentAllocations = AllocationCounter::getAllocations() - allocations;
+
+    allocations = AllocationCounter::getAllocations();
+    Server::PacketProcessor * temporaryProcessor = createPacketProcessor();
+    temporaryProcessor->processRequest(packet, replyChannel);
+    temporaryProcessor->deleteLater();
+    deliverReplies();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    quint64 perPacketAllocations = AllocationCounter::getAllocations() - allocations;
+
+    qInfo("Allocations per request: %llu persistent, %llu with a processor per packet, %llu for the processor alone",
+          persistentAllocations, perPacketAllocations, processorAllocations);
+    QVERIFY(processorAllocations > 0);
+    QVERIFY(persistentAllocations + processorAllocations <= perPacketAllocations);
+}
+
+QVariantList ServerBenchmarks::createMatchesReply()
+{
+    QVariantList responseData;
+    responseData << Packet::ID_PULL_MATCHES;
+
+    for(int i=0; i<MATCHES_CHUNK_SIZE; i++)
+    {
+        QVariantList matchData;
+        matchData << QString("Competitor %1").arg(i * 2) << QString("Competitor %1").arg(i * 2 + 1)
+                  << i % 5 << i % 3 << QString("17.10.2026 20:45") << unsigned(i + 1);
+        responseData << QVariant::fromValue(matchData);
+    }
+
+    return responseData;
+}
+
+QVariantList ServerBenchmarks::createPredictionsReply()
+{
+    QVariantList responseData;
+    responseData << Packet::ID_PULL_MATCHES_PREDICTIONS;
+
+    for(int i=0; i<PREDICTIONS_CHUNK_SIZE; i++)
+    {
+        QVariantList predictionData;
+        predictionData << QString("predictor%1").arg(i) << i % 4 << i % 2
+                       << QString("Competitor %1").arg(i * 2) << QString("Competitor %1").arg(i * 2 + 1);
+        responseData << QVariant::fromValue(predictionData);
+    }
+
+    return responseData;
+}
+
+QVariantList ServerBenchmarks::createLeaderboardReply()
+{
+    QVariantList responseData;
+    responseData << Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD;
+
+    for(int i=0; i<PARTICIPANTS_CHUNK_SIZE; i++)
+    {
+        QVariantList leaderboardData;
+        leaderboardData << QString("predictor%1").arg(i) << unsigned(i % 20) << unsigned(i % 40) << unsigned(i % 100);
+        responseData << QVariant::fromValue(leaderboardData);
+    }
+
+    return responseData;
+}
+
+void ServerBenchmarks::addReplyRows()
+{
+    QTest::addColumn<QVariantList>("packetData");
+    QTest::addColumn<int>("encoding");
+
+    // One full chunk of each of the large replies, the way the server streams them.
+    QTest::newRow("matches variant") << createMatchesReply() << int(Packet::ENCODING_VARIANT);
+    QTest::newRow("matches compact") << createMatchesReply() << int(Packet::ENCODING_COMPACT);
+    QTest::newRow("predictions variant") << createPredictionsReply() << int(Packet::ENCODING_VARIANT);
+    QTest::newRow("predictions compact") << createPredictionsReply() << int(Packet::ENCODING_COMPACT);
+    QTest::newRow("leaderboard variant") << createLeaderboardReply() << int(Packet::ENCODING_VARIANT);
+    QTest::newRow("leaderboard compact") << createLeaderboardReply() << int(Packet::ENCODING_COMPACT);
+}
+
+void ServerBenchmarks::encodePacket_data()
+{
+    addReplyRows();
+}
+
+void ServerBenchmarks::encodePacket()
+{
+    QFETCH(QVariantList, packetData);
+    QFETCH(int, encoding);
+
+    Packet encodedPacket(packetData, Packet::Encoding(encoding));
+    QVERIFY(!encodedPacket.isCorrupted());
+    qDebug("%d bytes on the wire", encodedPacket.getSerializedData().size());
+
+    QBENCHMARK
+    {
+        Packet packet(packetData, Packet::Encoding(encoding));
+    }
+}
+
+void ServerBenchmarks::decodePacket_data()
+{
+    addReplyRows();
+}
+
+void ServerBenchmarks::decodePacket()
+{
+    QFETCH(QVariantList, packetData);
+    QFETCH(int, encoding);
+
+    // The frame body without its size prefix, as PacketBuffer hands it over.
+    QByteArray packetBody = Packet(packetData, Packet::Encoding(encoding)).getSerializedData().mid(sizeof(quint32));
+
+    Packet decodedPacket;
+    decodedPacket.setUnserializedData(packetBody);
+    QVERIFY(!decodedPacket.isCorrupted());
+    QCOMPARE(decodedPacket.getUnserializedData().size(), packetData.size());
+
+    QBENCHMARK
+    {
+        Packet packet;
+        packet.setUnserializedData(packetBody);
+    }
+}
+
+void ServerBenchmarks::receiveFramesOnLoopback()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QTcpSocket client;
+    client.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    QVERIFY(client.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+
+    QScopedPointer<QTcpSocket> socket(server.nextPendingConnection());
+    QVERIFY(socket);
+
+    QByteArray frames;
+    Packet prediction(QVariantList() << Packet::ID_MAKE_PREDICTION_BY_ID << QString("benchmark") << 1u << 2u << 1u);
+
+    for(int i=0; i<FRAMES_PER_BATCH; i++)
+        frames += prediction.getSerializedData();
+
+    PacketBuffer buffer;
+    Packet packet;
+    int receivedFrames = 0;
+
+    // The same receive path as TcpConnection::read: bytes framed in one buffer, each body decoded once in place.
+    QBENCHMARK
+    {
+        client.write(frames);
+        receivedFrames = 0;
+
+        while(receivedFrames < FRAMES_PER_BATCH)
+        {
+            client.flush();
+
+            if(socket->bytesAvailable() == 0 && !socket->waitForReadyRead(5000))
+                break;
+
+            buffer.readFrom(socket.data());
+
+            while(buffer.takePacket(packet))
+                receivedFrames++;
+        }
+    }
+
+    QCOMPARE(receivedFrames, FRAMES_PER_BATCH);
+    QVERIFY(!packet.isCorrupted());
+}
+
+bool ServerBenchmarks::connectClients(quint16 port, int numberOfClients, QList<QSharedPointer<QTcpSocket> > & clients)
+{
+    for(int i=0; i<numberOfClients; i++)
+    {
+        QSharedPointer<QTcpSocket> client(new QTcpSocket());
+        client->connectToHost(QHostAddress::LocalHost, port);
+
+        if(!client->waitForConnected(5000))
+            return false;
+
+        clients << client;
+    }
+
+    return true;
+}
+
+int ServerBenchmarks::takeFinishedPulls(QTcpSocket * socket, PacketBuffer & buffer, int & pulledRows)
+{
+    Packet packet;
+    int finishedPulls = 0;
+    buffer.readFrom(socket);
+
+    // Matches arrive in ID_PULL_MATCHES chunks, each pull ends with one of these two packets.
+    while(buffer.takePacket(packet))
+    {
+        QVariantList packetData = packet.getUnserializedData();
+        int packetId = packetData.value(0).toInt();
+
+        if(packetId == Packet::ID_PULL_MATCHES)
+            pulledRows += packetData.size() - 1;
+        else if(packetId == Packet::ID_ALL_MATCHES_PULLED || packetId == Packet::ID_ZERO_MATCHES_TO_PULL)
+            finishedPulls++;
+    }
+
+    return finishedPulls;
+}
+
+bool ServerBenchmarks::seedRoundDatabase(const QString & databaseName, int numberOfMatches, unsigned int & roundId,
+                                         QList<unsigned int> & matchIds)
+{
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", "BenchmarkSetup");
+        database.setDatabaseName(databaseName);
+
+        if(!database.open() || !BenchmarkDatabase::createSchema(database))
+            return false;
+
+        QList<unsigned int> predictorIds;
+        unsigned int hostId = BenchmarkDatabase::addUser(database, "host", "password");
+
+        for(int i=0; i<NUMBER_OF_PREDICTORS; i++)
+            predictorIds << BenchmarkDatabase::addUser(database, QString("predictor%1").arg(i), "password");
+
+        roundId = BenchmarkDatabase::addOpenRound(database, hostId, predictorIds, numberOfMatches, matchIds);
+        database.close();
+    }
+    QSqlDatabase::removeDatabase("BenchmarkSetup");
+
+    return roundId > 0;
+}
+
+int ServerBenchmarks::pullRows(QTcpSocket * client, const Packet & request, int rowsPacketId, int trailerPacketId)
+{
+    PacketBuffer buffer;
+    Packet packet;
+    int pulledRows = 0;
+
+    client->write(request.getSerializedData());
+    client->flush();
+
+    while(client->bytesAvailable() > 0 || client->waitForReadyRead(5000))
+    {
+        buffer.readFrom(client);
+
+        while(buffer.takePacket(packet))
+        {
+            QVariantList packetData = packet.getUnserializedData();
+            int packetId = packetData.value(0).toInt();
+
+            if(packetId == rowsPacketId)
+                pulledRows += packetData.size() - 1;
+            else if(packetId == trailerPacketId || packetId == Packet::ID_ZERO_MATCHES_TO_PULL ||
+                    packetId == Packet::ID_ERROR)
+                return pulledRows;
+        }
+    }
+
+    return -1;
+}
+
+void ServerBenchmarks::pullMatchesOfSeededRound()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString databaseName = directory.filePath("pull.db");
+    QList<unsigned int> matchIds;
+    unsigned int roundId = 0;
+
+    // More matches than fit in one chunk, so the later pages continue from the cursor left by the first one.
+    QVERIFY(seedRoundDatabase(databaseName, MATCHES_CHUNK_SIZE + MATCHES_IN_ROUND, roundId, matchIds));
+
+    TcpServer server;
+    server.setDatabaseName(databaseName);
+    QVERIFY(server.startServer(0, QHostAddress::LocalHost));
+
+    QList<QSharedPointer<QTcpSocket> > clients;
+    QVERIFY(connectClients(quint16(server.port()), 1, clients));
+    QTRY_COMPARE_WITH_TIMEOUT(server.numberOfClients(), 1, 10000);
+
+    QTcpSocket * client = clients.first().data();
+    Packet pullById(QVariantList() << Packet::ID_PULL_MATCHES_BY_ID << roundId);
+    Packet pullByName(QVariantList() << Packet::ID_PULL_MATCHES << QString("Benchmark") << QString("host")
+                                     << QString("Benchmark"));
+    Packet pullPredictions(QVariantList() << Packet::ID_PULL_MATCHES_PREDICTIONS << QString("predictor0")
+                                          << QString("Benchmark") << QString("host") << QString("Benchmark"));
+
+    QCOMPARE(pullRows(client, pullById, Packet::ID_PULL_MATCHES, Packet::ID_ALL_MATCHES_PULLED), matchIds.size());
+    QCOMPARE(pullRows(client, pullByName, Packet::ID_PULL_MATCHES, Packet::ID_ALL_MATCHES_PULLED), matchIds.size());
+
+    // No match has started yet, so a predictor sees only its own prediction of each one.
+    QCOMPARE(pullRows(client, pullPredictions, Packet::ID_PULL_MATCHES_PREDICTIONS,
+                      Packet::ID_ALL_MATCHES_PREDICTIONS_PULLED), matchIds.size());
+
+    server.closeServer();
+    QTRY_VERIFY_WITH_TIMEOUT(server.isSafeToTerminate(), 10000);
+}
+
+void ServerBenchmarks::readThroughputUnderPredictionWrites_data()
+{
+    QTest::addColumn<int>("writesPerBatch");
+
+    QTest::newRow("reads only") << 0;
+    QTest::newRow("reads with prediction writes") << READS_PER_BATCH;
+}
+
+void ServerBenchmarks::readThroughputUnderPredictionWrites()
+{
+    QFETCH(int, writesPerBatch);
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    QString databaseName = directory.filePath("benchmark.db");
+    QList<unsigned int> matchIds;
+    unsigned int roundId = 0;
+    QVERIFY(seedRoundDatabase(databaseName, MATCHES_IN_ROUND, roundId, matchIds));
+
+    TcpServer server;
+    server.setDatabaseName(databaseName);
+    QVERIFY(server.startServer(0, QHostAddress::LocalHost));
+
+    // A connection has one request in flight at a time, so reads and writes are spread over many connections.
+    QList<QSharedPointer<QTcpSocket> > readers;
+    QList<QSharedPointer<QTcpSocket> > writers;
+    QVERIFY(connectClients(quint16(server.port()), NUMBER_OF_CLIENTS, readers));
+    QVERIFY(connectClients(quint16(server.port()), NUMBER_OF_CLIENTS, writers));
+    QTRY_COMPARE_WITH_TIMEOUT(server.numberOfClients(), NUMBER_OF_CLIENTS * 2, 10000);
+
+    for(auto writer : writers)
+    {
+        QTcpSocket * socket = writer.data();
+        connect(socket, &QTcpSocket::readyRead, [socket]() { socket->readAll(); });
+    }
+
+    QByteArray reads;
+    Packet read(QVariantList() << Packet::ID_PULL_MATCHES_BY_ID << roundId);
+
+    for(int i=0; i<READS_PER_BATCH / NUMBER_OF_CLIENTS; i++)
+        reads += read.getSerializedData();
+
+    QVector<PacketBuffer> buffers(NUMBER_OF_CLIENTS);
+    int finishedReads = 0;
+    int totalReads = 0;
+    int pulledRows = 0;
+    int score = 0;
+
+    // Only the reads are waited for; the writer keeps committing predictions while the next batch is read.
+    QBENCHMARK
+    {
+        score++;
+        finishedReads = 0;
+
+        for(int i=0; i<writesPerBatch; i++)
+        {
+            QString nickname = QString("predictor%1").arg(i % NUMBER_OF_PREDICTORS);
+            Packet write(QVariantList() << Packet::ID_UPDATE_PREDICTION_BY_ID << nickname
+                                        << matchIds.at(i % matchIds.size()) << score % 5 << i % 5);
+            writers.at(i % writers.size())->write(write.getSerializedData());
+        }
+
+        for(int i=0; i<NUMBER_OF_CLIENTS; i++)
+        {
+            readers.at(i)->write(reads);
+            readers.at(i)->flush();
+            writers.at(i)->flush();
+        }
+
+        for(int i=0; i<NUMBER_OF_CLIENTS; i++)
+        {
+            int finishedClientReads = 0;
+
+            while(finishedClientReads < READS_PER_BATCH / NUMBER_OF_CLIENTS)
+            {
+                if(readers.at(i)->bytesAvailable() == 0 && !readers.at(i)->waitForReadyRead(5000))
+                    break;
+
+                finishedClientReads += takeFinishedPulls(readers.at(i).data(), buffers[i], pulledRows);
+            }
+
+            finishedReads += finishedClientReads;
+        }
+
+        totalReads += finishedReads;
+
+        QCoreApplication::processEvents();
+    }
+
+    // An empty round answers just as fast, so every read of every batch must have brought the whole round back.
+    QCOMPARE(finishedReads, READS_PER_BATCH);
+    QCOMPARE(pulledRows, totalReads * MATCHES_IN_ROUND);
+
+    server.closeServer();
+    QTRY_VERIFY_WITH_TIMEOUT(server.isSafeToTerminate(), 10000);
+}
+
+bool ServerBenchmarks::prepareSearchDatabase()
+{
+    if(searchIndex)
+        return true;
+
+    searchDirectory = QSharedPointer<QTemporaryDir>(new QTemporaryDir());
+    QString databaseName = searchDirectory->filePath("search.db");
+
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", "BenchmarkSearchSetup");
+        database.setDatabaseName(databaseName);
+
+        if(!database.open() || !BenchmarkDatabase::createSchema(database))
+            return false;
+
+        QList<unsigned int> hostIds;
+
+        for(int i=0; i<NUMBER_OF_HOSTS; i++)
+            hostIds << BenchmarkDatabase::addUser(database, QString("host%1").arg(i), "password");
+
+        searcherId = BenchmarkDatabase::addUser(database, "searcher", "password");
+
+        if(!BenchmarkDatabase::addTournaments(database, hostIds, NUMBER_OF_TOURNAMENTS))
+            return false;
+
+        database.close();
+    }
+    QSqlDatabase::removeDatabase("BenchmarkSearchSetup");
+
+    searchConnection = QSharedPointer<DbConnection>(new DbConnection());
+
+    if(!searchConnection->connect("BenchmarkSearch", databaseName))
+        return false;
+
+    searchIndex = QSharedPointer<TournamentSearchIndex>(new TournamentSearchIndex());
+    return searchIndex->rebuild(databaseName);
+}
+
+void ServerBenchmarks::searchTournaments_data()
+{
+    QTest::addColumn<bool>("indexed");
+    QTest::addColumn<QString>("tournamentName");
+
+    QTest::newRow("index, no name") << true << QString();
+    QTest::newRow("sql, no name") << false << QString();
+    QTest::newRow("index, common words") << true << QString("premier cup");
+    QTest::newRow("sql, common words") << false << QString("premier cup");
+    QTest::newRow("index, single tournament") << true << QString("classic 876543");
+    QTest::newRow("sql, single tournament") << false << QString("classic 876543");
+}
+
+void ServerBenchmarks::searchTournaments()
+{
+    QFETCH(bool, indexed);
+    QFETCH(QString, tournamentName);
+
+    QVERIFY(prepareSearchDatabase());
+    QDateTime now = QDateTime::currentDateTime();
+    Query query(searchConnection);
+    int found = 0;
+
+    // Both sides of ID_PULL_TOURNAMENTS: the in-memory trigram index and the LIKE query it replaced.
+    QBENCHMARK
+    {
+        found = 0;
+
+        if(indexed)
+            found = searchIndex->find(searcherId, now, SEARCH_ITEMS_LIMIT, tournamentName).size();
+        else
+        {
+            query.findTournaments(searcherId, now, SEARCH_ITEMS_LIMIT, tournamentName);
+
+            while(query.next())
+                found++;
+        }
+    }
+
+    QVERIFY(found > 0);
+
+    // Not timed: the index must find the same tournaments as the query, in the same order.
+    QList<unsigned int> indexedIds;
+
+    for(auto entry : searchIndex->find(searcherId, now, SEARCH_ITEMS_LIMIT, tournamentName))
+        indexedIds << entry.id;
+
+    QList<unsigned int> queriedIds;
+    query.findTournaments(searcherId, now, SEARCH_ITEMS_LIMIT, tournamentName);
+
+    while(query.next())
+        queriedIds << query.value("id").toUInt();
+
+    QCOMPARE(indexedIds, queriedIds);
+}
+
+QTEST_GUILESS_MAIN(ServerBenchmarks)
@@ -0,0 +1,88 @@
+#ifndef SERVERBENCHMARKS_H
+#define SERVERBENCHMARKS_H
+
+#include <QObject>
+#include <QVariantList>
+#include <QSharedPointer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <dbconnection.h>
+#include <tcpconnections.h>
+#include <replychannel.h>
+#include <leaderboardengine.h>
+#include <tournamentsearchindex.h>
+#include <avatarstore.h>
+#include <responsecache.h>
+#include <packetprocessor.h>
+#include <packetbuffer.h>
+
+class ServerBenchmarks : public QObject
+{
+    Q_OBJECT
+
+private:
+    QSharedPointer<DbConnection> dbConnection;
+    TcpConnections * connectionsPool;
+    QSharedPointer<ReplyChannel> replyChannel;
+    QSharedPointer<LeaderboardEngine> leaderboards;
+    QSharedPointer<TournamentSearchIndex> tournamentSearch;
+    QSharedPointer<AvatarStore> avatars;
+    QSharedPointer<ResponseCache> responses;
+    QSharedPointer<QTemporaryDir> searchDirectory;
+    QSharedPointer<DbConnection> searchConnection;
+    QSharedPointer<TournamentSearchIndex> searchIndex;
+    unsigned int searcherId;
+
+    static const int MATCHES_CHUNK_SIZE = 250;
+    static const int PREDICTIONS_CHUNK_SIZE = 250;
+    static const int PARTICIPANTS_CHUNK_SIZE = 500;
+    static const int FRAMES_PER_BATCH = 1000;
+    static const int READS_PER_BATCH = 200;
+    static const int NUMBER_OF_CLIENTS = 20;
+    static const int NUMBER_OF_PREDICTORS = 50;
+    static const int MATCHES_IN_ROUND = 100;
+    static const int NUMBER_OF_TOURNAMENTS = 1000000;
+    static const int NUMBER_OF_HOSTS = 1000;
+    static const int SEARCH_ITEMS_LIMIT = 20;
+
+    Server::PacketProcessor * createPacketProcessor();
+    void deliverReplies();
+    bool prepareSearchDatabase();
+    static QVariantList createMatchesReply();
+    static QVariantList createPredictionsReply();
+    static QVariantList createLeaderboardReply();
+    static void addReplyRows();
+    static bool connectClients(quint16 port, int numberOfClients, QList<QSharedPointer<QTcpSocket> > & clients);
+    static int takeFinishedPulls(QTcpSocket * socket, PacketBuffer & buffer, int & pulledRows);
+    static bool seedRoundDatabase(const QString & databaseName, int numberOfMatches, unsigned int & roundId,
+                                  QList<unsigned int> & matchIds);
+    static int pullRows(QTcpSocket * client, const Packet & request, int rowsPacketId, int trailerPacketId);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void processRequestWithProcessorPerPacket();
+    void processRequestWithPersistentProcessor();
+
+    void encodePacket_data();
+    void encodePacket();
+    void decodePacket_data();
+    void decodePacket();
+
+    void receiveFramesOnLoopback();
+
+    void pullMatchesOfSeededRound();
+
+    void readThroughputUnderPredictionWrites_data();
+    void readThroughputUnderPredictionWrites();
+
+    void searchTournaments_data();
+    void searchTournaments();
+
+public:
+    explicit ServerBenchmarks(QObject * parent = nullptr);
+    ~ServerBenchmarks() {}
+};
+
+#endif // SERVERBENCHMARKS_H
@@ -19,7 +19,7 @@ Item {
     property bool loadingState: false
     signal creatingNewMatch()
     signal removingMatch(var firstCompetitor, var secondCompetitor)
-    signal updatingMatchScore(var firstCompetitor, var secondCompetitor, var firstScore, var secondScore)
+    signal updatingMatchScore(var firstCompetitor, var secondCompetitor, var firstScore, var secondScore, var matchId)
     signal deniedRequest(var message)
     signal makingPrediction(var predictionData)
     signal updatingMatchPrediction(var updatedPrediction)
@@ -333,6 +333,7 @@ Item {
                                     var predictionData = {}
                                     predictionData.firstCompetitor = firstCompetitor
                                     predictionData.secondCompetitor = secondCompetitor
+                                    predictionData.matchId = matchId
                                     predictionData.firstCompetitorPredictedScore =
                                             parseInt(initialPredictionScoreInput.enteredLeftScore)
                                     predictionData.secondCompetitorPredictedScore =
@@ -401,7 +402,7 @@ Item {
                                                             parseInt(scoreInput.enteredRightScore)
 
                                     updatingMatchScore(firstCompetitor, secondCompetitor,
-                                                       updatedLeftScore, updatedRightScore)
+                                                       updatedLeftScore, updatedRightScore, matchId)
                                 }
                             }
 
@@ -567,6 +568,7 @@ Item {
                                 var updatedPrediction = {}
                                 updatedPrediction.firstCompetitor = firstCompetitor
                                 updatedPrediction.secondCompetitor = secondCompetitor
+                                updatedPrediction.matchId = matchId
 
                                 updatedPrediction.firstCompetitorPredictedScore =
                                                   predictedScoreInput.enteredLeftScore.length === 0 ?
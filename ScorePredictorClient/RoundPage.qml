@@ -46,6 +46,13 @@ Page {
                 }
 
                 onUpdatingMatchScore: {
+                    if(matchId > 0)
+                    {
+                        backend.updateMatchScoreById(currentTournament.hostName, matchId, firstScore, secondScore)
+                        mainWindow.startLoading(busyTimer, navigationPage)
+                        return
+                    }
+
                     var match = Qt.createQmlObject('import QtQuick 2.0;import DataStorage 1.0; Match {}', roundPage);
                     match.firstCompetitor = firstCompetitor
                     match.secondCompetitor = secondCompetitor
@@ -323,6 +330,7 @@ Page {
                 match.predictionsEndTime = predictionsEndDateText.text + " " + predictionsEndTimePicker.time
                 match.predictions = []
                 match.currentUserMadePrediction = false
+                match.matchId = matchId
 
                 listOfMatches.addMatch(match)
             }
@@ -17,6 +17,7 @@ SOURCES += main.cpp \
     tcpclient.cpp \
     tcpclientwrapper.cpp \
     ../ScorePredictorServer/packet.cpp \
+    ../ScorePredictorServer/packetbuffer.cpp \
     user.cpp \
     tournament.cpp \
     packetprocessor.cpp \
@@ -45,6 +46,7 @@ HEADERS += \
     tcpclient.h \
     tcpclientwrapper.h \
     ../ScorePredictorServer/packet.h \
+    ../ScorePredictorServer/packetbuffer.h \
     user.h \
     tournament.h \
     packetprocessor.h \
@@ -2,6 +2,7 @@ import QtQuick 2.9
 import QtQuick.Controls 2.3
 import QtQuick.Layouts 1.3
 import QtQuick.Dialogs 1.3
+import QtQuick.Window 2.2
 import "../components"
 import "../reusableWidgets"
 
@@ -460,7 +461,7 @@ Page {
         onUserInfoDownloadReply: {
             nicknameText.text = currentUser.username
             profileDescription.text = description
-            userAvatar.source = "image://images/avatar"
+            userAvatar.source = "image://images/avatar/" + avatarHash
         }
 
         onFinishedTournamentsListArrived: {
@@ -539,7 +540,7 @@ Page {
 
     function downloadProfile()
     {
-        backend.downloadUserProfileInfo(currentUser.username)
+        backend.downloadUserProfileInfo(currentUser.username, userAvatar.width * Screen.devicePixelRatio)
         backend.pullFinishedTournaments(currentUser.username)
         backend.pullOngoingTournaments(currentUser.username)
     }
@@ -58,10 +58,10 @@ void BackEnd::registerAccount(const QString & nickname, const QString & password
     emit clientWrapper->sendData(data);
 }
 
-void BackEnd::downloadUserProfileInfo(const QString & nickname)
+void BackEnd::downloadUserProfileInfo(const QString & nickname, int avatarSize)
 {
     QVariantList data;
-    data << Packet::ID_DOWNLOAD_USER_PROFILE_INFO << nickname;
+    data << Packet::ID_DOWNLOAD_USER_PROFILE_INFO << nickname << imageProvider->findAvatarHash(nickname) << avatarSize;
     emit clientWrapper->sendData(data);
 }
 
@@ -213,6 +213,14 @@ void BackEnd::updateMatchScore(Match * match)
     emit clientWrapper->sendData(data);
 }
 
+void BackEnd::updateMatchScoreById(const QString & hostName, unsigned int matchId,
+                                   unsigned int firstCompetitorScore, unsigned int secondCompetitorScore)
+{
+    QVariantList data;
+    data << Packet::ID_UPDATE_MATCH_SCORE_BY_ID << hostName << matchId << firstCompetitorScore << secondCompetitorScore;
+    emit clientWrapper->sendData(data);
+}
+
 void BackEnd::pullMatchesPredictions(const QString & requesterName, const QString & tournamentName,
                                      const QString & hostName, const QString & roundName)
 {
@@ -224,6 +232,18 @@ void BackEnd::pullMatchesPredictions(const QString & requesterName, const QStrin
 void BackEnd::makePrediction(const QVariantMap & predictionData)
 {
     QVariantList data;
+
+    if(predictionData.value("matchId").toUInt() > 0)
+    {
+        data << Packet::ID_MAKE_PREDICTION_BY_ID << predictionData.value("nickname")
+             << predictionData.value("matchId").toUInt()
+             << predictionData.value("firstCompetitorPredictedScore")
+             << predictionData.value("secondCompetitorPredictedScore");
+
+        emit clientWrapper->sendData(data);
+        return;
+    }
+
     data << Packet::ID_MAKE_PREDICTION << predictionData.value("nickname") << predictionData.value("tournamentName")
          << predictionData.value("tournamentHostName") << predictionData.value("roundName")
          << predictionData.value("firstCompetitor") << predictionData.value("secondCompetitor")
@@ -236,6 +256,18 @@ void BackEnd::makePrediction(const QVariantMap & predictionData)
 void BackEnd::updatePrediction(const QVariantMap & updatedPrediction)
 {
     QVariantList data;
+
+    if(updatedPrediction.value("matchId").toUInt() > 0)
+    {
+        data << Packet::ID_UPDATE_PREDICTION_BY_ID << updatedPrediction.value("nickname")
+             << updatedPrediction.value("matchId").toUInt()
+             << updatedPrediction.value("firstCompetitorPredictedScore")
+             << updatedPrediction.value("secondCompetitorPredictedScore");
+
+        emit clientWrapper->sendData(data);
+        return;
+    }
+
     data << Packet::ID_UPDATE_PREDICTION << updatedPrediction.value("nickname")
          << updatedPrediction.value("tournamentName")
          << updatedPrediction.value("tournamentHostName") << updatedPrediction.value("roundName")
@@ -39,7 +39,7 @@ public:
     Q_INVOKABLE void login(const QString & nickname, const QString & password);
     Q_INVOKABLE void registerAccount(const QString & nickname, const QString & password);
 
-    Q_INVOKABLE void downloadUserProfileInfo(const QString & nickname);
+    Q_INVOKABLE void downloadUserProfileInfo(const QString & nickname, int avatarSize = 0);
     Q_INVOKABLE void pullFinishedTournaments(const QString & nickname);
     Q_INVOKABLE void pullOngoingTournaments(const QString & nickname);
 
@@ -66,6 +66,8 @@ public:
     Q_INVOKABLE void createNewMatch(Match * newMatch);
     Q_INVOKABLE void deleteMatch(Match * match);
     Q_INVOKABLE void updateMatchScore(Match * match);
+    Q_INVOKABLE void updateMatchScoreById(const QString & hostName, unsigned int matchId,
+                                          unsigned int firstCompetitorScore, unsigned int secondCompetitorScore);
 
     Q_INVOKABLE void pullMatchesPredictions(const QString & requesterName, const QString & tournamentName,
                                             const QString & hostName, const QString & roundName);
@@ -1,19 +1,41 @@
 #include "imageprovider.h"
+#include <QStandardPaths>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
 
 ImageProvider::ImageProvider() : QObject(nullptr), QQuickImageProvider(QQuickImageProvider::Image)
 {
+    images.setMaxCost(MEMORY_CACHE_CAPACITY);
 
+    cacheDirectory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/avatars";
+    QDir().mkpath(cacheDirectory);
+
+    avatarIndex = new QSettings(cacheDirectory + "/index.ini", QSettings::IniFormat, this);
 }
 
 QImage ImageProvider::requestImage(const QString & id, QSize * size, const QSize & requestedSize)
 {
-    Q_UNUSED(id)
+    // Ids look like "avatar/<hash>", the hash alone identifies the image.
+    QString hash = id.section('/', -1);
     QImage image;
 
-    if(!imageData.isEmpty() && !imageData.isNull())
     {
-        image.loadFromData(imageData);
-        imageData.clear();
+        QMutexLocker locker(&mutex);
+        QImage * cachedImage = images.object(hash);
+
+        if(cachedImage)
+            image = *cachedImage;
+    }
+
+    if(image.isNull() && !hash.isEmpty() && image.load(cachePath(hash)))
+    {
+        QMutexLocker locker(&mutex);
+        images.insert(hash, new QImage(image), image.sizeInBytes());
+    }
+
+    if(!image.isNull())
+    {
         *size = image.size();
 
         if(requestedSize.isValid())
@@ -23,7 +45,47 @@ QImage ImageProvider::requestImage(const QString & id, QSize * size, const QSize
     return image;
 }
 
-void ImageProvider::setImageData(const QByteArray & data)
+QByteArray ImageProvider::findAvatarHash(const QString & nickname)
+{
+    QByteArray hash = avatarIndex->value(nickname).toByteArray();
+
+    // The index may outlive files removed from the cache directory.
+    if(hash.isEmpty() || !QFile::exists(cachePath(hash)))
+        return QByteArray();
+
+    return hash;
+}
+
+void ImageProvider::setImageData(const QByteArray & data, const QByteArray & hash, const QString & nickname)
+{
+    // The hash becomes a file name, so anything other than plain hex is rejected.
+    if(hash.isEmpty() || QByteArray::fromHex(hash).toHex() != hash)
+        return;
+
+    // Empty data means the server confirmed the cached copy is still current.
+    if(!data.isEmpty())
+    {
+        QImage image;
+
+        if(!image.loadFromData(data))
+            return;
+
+        QSaveFile file(cachePath(hash));
+
+        if(file.open(QIODevice::WriteOnly) && file.write(data) == data.size())
+            file.commit();
+        else
+            file.cancelWriting();
+
+        QMutexLocker locker(&mutex);
+        images.insert(QString::fromLatin1(hash), new QImage(image), image.sizeInBytes());
+    }
+
+    if(!nickname.isEmpty())
+        avatarIndex->setValue(nickname, hash);
+}
+
+QString ImageProvider::cachePath(const QString & hash) const
 {
-    imageData = data;
+    return cacheDirectory + "/" + hash + ".png";
 }
@@ -3,13 +3,23 @@
 
 #include <QObject>
 #include <QQuickImageProvider>
+#include <QCache>
+#include <QMutex>
+#include <QSettings>
 
 class ImageProvider : public QObject, public QQuickImageProvider
 {
     Q_OBJECT
 
 private:
-    QByteArray imageData;
+    QCache<QString, QImage> images;
+    QString cacheDirectory;
+    QSettings * avatarIndex;
+    QMutex mutex;
+
+    static const int MEMORY_CACHE_CAPACITY = 16 * 1024 * 1024;
+
+    QString cachePath(const QString & hash) const;
 
 public:
     explicit ImageProvider();
@@ -17,8 +27,10 @@ public:
 
     QImage requestImage(const QString & id, QSize * size, const QSize & requestedSize) override;
 
+    QByteArray findAvatarHash(const QString & nickname);
+
 public slots:
-    void setImageData(const QByteArray & data);
+    void setImageData(const QByteArray & data, const QByteArray & hash, const QString & nickname);
 };
 
 #endif // IMAGEPROVIDER_H
@@ -75,8 +75,9 @@ namespace Client
 
     void PacketProcessor::manageUserInfoReply(const QVariantList & replyData)
     {
-        emit avatarDataReceived(replyData[1].toByteArray());
-        emit userInfoDownloadReply(replyData[0].toString());
+        emit avatarDataReceived(replyData[1].toByteArray(), replyData.value(2).toByteArray(),
+                                replyData.value(3).toString());
+        emit userInfoDownloadReply(replyData[0].toString(), replyData.value(2).toString());
     }
 
     void PacketProcessor::manageFinishedTournamentsPullReply(const QVariantList & replyData)
@@ -224,6 +225,7 @@ namespace Client
             match.insert("firstCompetitorScore", matchData[2]);
             match.insert("secondCompetitorScore", matchData[3]);
             match.insert("predictionsEndTime", matchData[4]);
+            match.insert("matchId", matchData.size() > 5 ? matchData[5].toUInt() : 0);
 
             emit matchItemArrived(match);
         }
@@ -241,7 +243,8 @@ namespace Client
 
     void PacketProcessor::manageMatchCreatingReply(const QVariantList & replyData)
     {
-        emit creatingNewMatchReply(replyData[0].toBool(), replyData[1].toString());
+        unsigned int matchId = replyData.size() > 2 ? replyData[2].toUInt() : 0;
+        emit creatingNewMatchReply(replyData[0].toBool(), replyData[1].toString(), matchId);
     }
 
     void PacketProcessor::manageMatchDeletedReply(const QVariantList & replyData)
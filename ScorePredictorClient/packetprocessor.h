@@ -69,8 +69,8 @@ namespace Client
         void registrationReply(bool replyState, const QString & message);
         void loggingReply(bool nicknameState, bool passwordState, const QString & message);
 
-        void userInfoDownloadReply(const QString & description);
-        void avatarDataReceived(const QByteArray & avatarData);
+        void userInfoDownloadReply(const QString & description, const QString & avatarHash);
+        void avatarDataReceived(const QByteArray & avatarData, const QByteArray & avatarHash, const QString & nickname);
         void finishedTournamentsListArrived(int numberOfItems);
         void finishedTournamentsListItemArrived(const QString & tournamentName, const QString & hostName);
         void ongoingTournamentsListArrived(int numberOfItems);
@@ -99,7 +99,7 @@ namespace Client
         void zeroMatchesToPull();
         void allMatchesPulled();
 
-        void creatingNewMatchReply(bool replyState, const QString & message);
+        void creatingNewMatchReply(bool replyState, const QString & message, unsigned int matchId);
         void matchDeleted(const QString & firstCompetitor, const QString & secondCompetitor);
         void matchDeletingError(const QString & message);
         void matchScoreUpdated(const QVariantMap & updatedMatch);
@@ -3,7 +3,8 @@
 TcpClient::TcpClient(QObject * parent) : QObject(parent)
 {
     socket = new QTcpSocket(this);
-    nextPacketSize = 0;
+    encoding = Packet::ENCODING_VARIANT;
+    preferredEncoding = Packet::ENCODING_COMPACT;
 
     connect(socket, &QTcpSocket::connected, this, &TcpClient::connected);
     connect(socket, &QTcpSocket::disconnected, this, &TcpClient::disconnected);
@@ -22,7 +23,9 @@ bool TcpClient::connectToServer(const QHostAddress & address, quint16 port)
 
     if(socket->waitForConnected())
     {
-        nextPacketSize = 0;
+        readBuffer.clear();
+        encoding = Packet::ENCODING_VARIANT;
+        negotiateEncoding();
         emit started();
         return true;
     }
@@ -50,31 +53,31 @@ void TcpClient::disconnected()
 
 void TcpClient::read()
 {
-    QDataStream in(socket);
-    in.setVersion(QDataStream::Qt_5_10);
+    Packet packet;
 
-    if(nextPacketSize == 0)
+    while(readBuffer.readFrom(socket) > 0)
     {
-        if(socket->bytesAvailable() < sizeof(quint16))
-            return;
-
-        in >> nextPacketSize;
+        while(readBuffer.takePacket(packet))
+        {
+            if(packet.isCorrupted())
+                continue;
+            else if(packet.getUnserializedData()[0].toInt() == Packet::ID_NEGOTIATE_ENCODING)
+            {
+                if(packet.getUnserializedData().value(1).toInt() == Packet::ENCODING_COMPACT)
+                    encoding = Packet::ENCODING_COMPACT;
+                else
+                    encoding = Packet::ENCODING_VARIANT;
+            }
+            else
+                emit packetArrived(packet);
+        }
     }
 
-    if(socket->bytesAvailable() < nextPacketSize)
-        return;
-
-    Packet packet(in);
-
-    if(packet.isCorrupted())
+    if(readBuffer.hasOverflowed())
+    {
+        readBuffer.clear();
         flushSocket();
-    else
-        emit packetArrived(packet);
-
-    nextPacketSize = 0;
-
-    if(socket->bytesAvailable() >= sizeof(quint16))
-        read();
+    }
 }
 
 void TcpClient::send(const QVariantList & data)
@@ -82,12 +85,27 @@ void TcpClient::send(const QVariantList & data)
     if(socket->state() != QTcpSocket::ConnectedState)
         return;
 
-    Packet packet(data);
+    Packet packet(data, encoding);
 
     if(!packet.isCorrupted())
         socket->write(packet.getSerializedData());
 }
 
+void TcpClient::negotiateEncoding()
+{
+    if(preferredEncoding == Packet::ENCODING_VARIANT)
+        return;
+
+    QVariantList data;
+    data << Packet::ID_NEGOTIATE_ENCODING << int(preferredEncoding);
+    send(data);
+}
+
+void TcpClient::setPreferredEncoding(Packet::Encoding value)
+{
+    preferredEncoding = value;
+}
+
 void TcpClient::flushSocket()
 {
     if(socket->bytesAvailable())
@@ -3,6 +3,7 @@
 
 #include <QTcpSocket>
 #include <../ScorePredictorServer/packet.h>
+#include <../ScorePredictorServer/packetbuffer.h>
 
 class TcpClient : public QObject
 {
@@ -10,9 +11,12 @@ class TcpClient : public QObject
 
 private:
     QTcpSocket * socket;
-    quint16 nextPacketSize;
+    PacketBuffer readBuffer;
+    Packet::Encoding encoding;
+    Packet::Encoding preferredEncoding;
 
     void flushSocket();
+    void negotiateEncoding();
 
 private slots:
     void read();
@@ -25,6 +29,8 @@ public:
     explicit TcpClient(QObject * parent = nullptr);
     ~TcpClient() {}
 
+    void setPreferredEncoding(Packet::Encoding value);
+
 public slots:
     bool connectToServer(const QHostAddress & address, quint16 port);
     void disconnectFromServer();
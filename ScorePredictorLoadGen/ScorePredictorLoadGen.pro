@@ -0,0 +1,34 @@
+QT += network
+QT -= gui
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# The following define makes your compiler emit warnings if you use
+# any feature of Qt which as been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# The server sources include each other with angle brackets.
+INCLUDEPATH += ../ScorePredictorServer
+
+SOURCES += main.cpp \
+    loadconnection.cpp \
+    loadgenerator.cpp \
+    loadstatistics.cpp \
+    requestmix.cpp \
+    ../ScorePredictorServer/packet.cpp \
+    ../ScorePredictorServer/packetbuffer.cpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+HEADERS += \
+    loadconnection.h \
+    loadgenerator.h \
+    loadstatistics.h \
+    requestmix.h \
+    ../ScorePredictorServer/packet.h \
+    ../ScorePredictorServer/packetbuffer.h
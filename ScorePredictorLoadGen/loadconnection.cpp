@@ -0,0 +1,138 @@
+#include "loadconnection.h"
+
+LoadConnection::LoadConnection(const QHostAddress & serverAddress, quint16 serverPort,
+                               QSharedPointer<const RequestMix> mix, QSharedPointer<LoadStatistics> loadStatistics,
+                               Packet::Encoding packetEncoding) : QObject(nullptr)
+{
+    socket = nullptr;
+    address = serverAddress;
+    port = serverPort;
+    encoding = Packet::ENCODING_VARIANT;
+    preferredEncoding = packetEncoding;
+    requestMix = mix;
+    statistics = loadStatistics;
+    pendingPacketId = NO_PENDING_PACKET;
+    running = false;
+    established = false;
+}
+
+void LoadConnection::start()
+{
+    if(running)
+        return;
+
+    running = true;
+    socket = new QTcpSocket(this);
+
+    connect(socket, &QTcpSocket::connected, this, &LoadConnection::connected);
+    connect(socket, &QTcpSocket::disconnected, this, &LoadConnection::disconnected);
+    connect(socket, &QTcpSocket::readyRead, this, &LoadConnection::read);
+    connect(socket, static_cast<void (QTcpSocket::*) (QAbstractSocket::SocketError)>(&QTcpSocket::error),
+            this, &LoadConnection::error);
+
+    socket->connectToHost(address, port);
+}
+
+void LoadConnection::stop()
+{
+    running = false;
+
+    if(socket)
+        socket->abort();
+}
+
+void LoadConnection::connected()
+{
+    established = true;
+    readBuffer.clear();
+
+    // The first request waits for the encoding acknowledgement, like TcpClient does.
+    if(preferredEncoding == Packet::ENCODING_VARIANT)
+    {
+        sendNextRequest();
+        return;
+    }
+
+    QVariantList data;
+    data << Packet::ID_NEGOTIATE_ENCODING << int(preferredEncoding);
+    socket->write(Packet(data, encoding).getSerializedData());
+}
+
+void LoadConnection::disconnected()
+{
+    if(!running)
+        return;
+
+    if(pendingPacketId != NO_PENDING_PACKET)
+        finishRequest(true);
+
+    statistics->recordDisconnection();
+    running = false;
+}
+
+void LoadConnection::error(QAbstractSocket::SocketError socketError)
+{
+    Q_UNUSED(socketError)
+
+    // Errors of an established connection end up in disconnected(), this only catches failed attempts.
+    if(!running || established)
+        return;
+
+    statistics->recordDisconnection();
+    running = false;
+}
+
+void LoadConnection::read()
+{
+    Packet packet;
+
+    while(readBuffer.readFrom(socket) > 0)
+    {
+        while(readBuffer.takePacket(packet))
+        {
+            if(!packet.isCorrupted())
+                processPacket(packet.getUnserializedData());
+        }
+    }
+
+    if(readBuffer.hasOverflowed())
+        socket->abort();
+}
+
+void LoadConnection::processPacket(const QVariantList & data)
+{
+    int packetId = data[0].toInt();
+
+    if(packetId == Packet::ID_NEGOTIATE_ENCODING)
+    {
+        encoding = data.value(1).toInt() == Packet::ENCODING_COMPACT ? Packet::ENCODING_COMPACT : Packet::ENCODING_VARIANT;
+        sendNextRequest();
+    }
+    // Matches arrive in chunks, the request is complete only once the trailer comes.
+    else if(packetId != Packet::ID_PULL_MATCHES && pendingPacketId != NO_PENDING_PACKET)
+    {
+        finishRequest(packetId == Packet::ID_ERROR);
+        sendNextRequest();
+    }
+}
+
+void LoadConnection::sendNextRequest()
+{
+    if(!running || socket->state() != QTcpSocket::ConnectedState)
+        return;
+
+    QVariantList request = requestMix->nextRequest();
+
+    if(request.isEmpty())
+        return;
+
+    pendingPacketId = request[0].toInt();
+    requestTimer.start();
+    socket->write(Packet(request, encoding).getSerializedData());
+}
+
+void LoadConnection::finishRequest(bool failed)
+{
+    statistics->record(pendingPacketId, requestTimer.nsecsElapsed() / 1000, failed);
+    pendingPacketId = NO_PENDING_PACKET;
+}
@@ -0,0 +1,53 @@
+#ifndef LOADCONNECTION_H
+#define LOADCONNECTION_H
+
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include <packet.h>
+#include <packetbuffer.h>
+#include <requestmix.h>
+#include <loadstatistics.h>
+
+class LoadConnection : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTcpSocket * socket;
+    PacketBuffer readBuffer;
+    QHostAddress address;
+    quint16 port;
+    Packet::Encoding encoding;
+    Packet::Encoding preferredEncoding;
+    QSharedPointer<const RequestMix> requestMix;
+    QSharedPointer<LoadStatistics> statistics;
+    QElapsedTimer requestTimer;
+    int pendingPacketId;
+    bool running;
+    bool established;
+
+    static const int NO_PENDING_PACKET = -1;
+
+    void sendNextRequest();
+    void finishRequest(bool failed);
+    void processPacket(const QVariantList & data);
+
+private slots:
+    void connected();
+    void disconnected();
+    void read();
+    void error(QAbstractSocket::SocketError socketError);
+
+public:
+    LoadConnection(const QHostAddress & serverAddress, quint16 serverPort, QSharedPointer<const RequestMix> mix,
+                   QSharedPointer<LoadStatistics> loadStatistics, Packet::Encoding packetEncoding);
+    ~LoadConnection() {}
+
+public slots:
+    void start();
+    void stop();
+};
+
+#endif // LOADCONNECTION_H
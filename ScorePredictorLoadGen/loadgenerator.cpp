@@ -0,0 +1,71 @@
+#include "loadgenerator.h"
+
+LoadGenerator::LoadGenerator(QObject * parent) : QObject(parent)
+{
+    statistics = QSharedPointer<LoadStatistics>(new LoadStatistics());
+    elapsedTime = 0;
+    running = false;
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    stop();
+}
+
+void LoadGenerator::start(const QHostAddress & address, quint16 port, int numberOfConnections, int numberOfThreads,
+                          QSharedPointer<const RequestMix> mix, Packet::Encoding encoding)
+{
+    if(running || numberOfConnections < 1 || numberOfThreads < 1)
+        return;
+
+    running = true;
+
+    for(int i=0; i<numberOfThreads; i++)
+    {
+        QThread * thread = new QThread(this);
+        threads.append(thread);
+        thread->start();
+    }
+
+    for(int i=0; i<numberOfConnections; i++)
+    {
+        QThread * thread = threads.at(i % numberOfThreads);
+        LoadConnection * connection = new LoadConnection(address, port, mix, statistics, encoding);
+
+        connection->moveToThread(thread);
+        connect(thread, &QThread::finished, connection, &QObject::deleteLater);
+        connections.append(connection);
+
+        QMetaObject::invokeMethod(connection, "start", Qt::QueuedConnection);
+    }
+
+    runTimer.start();
+}
+
+void LoadGenerator::stop()
+{
+    if(!running)
+        return;
+
+    running = false;
+    elapsedTime = runTimer.elapsed();
+
+    // Blocking, so no connection records a request once the report is being put together.
+    for(auto connection : connections)
+        QMetaObject::invokeMethod(connection, "stop", Qt::BlockingQueuedConnection);
+
+    for(auto thread : threads)
+    {
+        thread->quit();
+        thread->wait();
+    }
+
+    connections.clear();
+    qDeleteAll(threads);
+    threads.clear();
+}
+
+QString LoadGenerator::report() const
+{
+    return statistics->report(running ? runTimer.elapsed() : elapsedTime);
+}
@@ -0,0 +1,32 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QObject>
+#include <QThread>
+#include <QElapsedTimer>
+#include <loadconnection.h>
+
+class LoadGenerator : public QObject
+{
+    Q_OBJECT
+
+private:
+    QList<QThread *> threads;
+    QList<LoadConnection *> connections;
+    QSharedPointer<LoadStatistics> statistics;
+    QElapsedTimer runTimer;
+    qint64 elapsedTime;
+    bool running;
+
+public:
+    explicit LoadGenerator(QObject * parent = nullptr);
+    ~LoadGenerator();
+
+    void start(const QHostAddress & address, quint16 port, int numberOfConnections, int numberOfThreads,
+               QSharedPointer<const RequestMix> mix, Packet::Encoding encoding);
+    void stop();
+
+    QString report() const;
+};
+
+#endif // LOADGENERATOR_H
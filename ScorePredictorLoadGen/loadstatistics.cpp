@@ -0,0 +1,60 @@
+#include "loadstatistics.h"
+#include <algorithm>
+
+LoadStatistics::LoadStatistics()
+{
+    disconnections = 0;
+}
+
+void LoadStatistics::record(int packetId, qint64 latencyMicroseconds, bool failed)
+{
+    QMutexLocker locker(&mutex);
+
+    if(!packets.contains(packetId))
+        packets[packetId].failures = 0;
+
+    PacketStatistics & statistics = packets[packetId];
+    statistics.latencies.append(latencyMicroseconds);
+
+    if(failed)
+        statistics.failures++;
+}
+
+void LoadStatistics::recordDisconnection()
+{
+    QMutexLocker locker(&mutex);
+    disconnections++;
+}
+
+QString LoadStatistics::report(qint64 elapsedMilliseconds) const
+{
+    QMutexLocker locker(&mutex);
+    double elapsedSeconds = qMax<qint64>(elapsedMilliseconds, 1) / 1000.0;
+    QString table = QString("%1 %2 %3 %4 %5 %6 %7\n").arg("packet", 8).arg("requests", 10).arg("errors", 8)
+                    .arg("req/s", 10).arg("p50 ms", 10).arg("p99 ms", 10).arg("p99.9 ms", 10);
+
+    for(auto packetId : packets.keys())
+    {
+        QVector<qint64> latencies = packets[packetId].latencies;
+        std::sort(latencies.begin(), latencies.end());
+
+        table += QString("%1 %2 %3 %4 %5 %6 %7\n").arg(packetId, 8).arg(latencies.size(), 10)
+                 .arg(packets[packetId].failures, 8).arg(latencies.size() / elapsedSeconds, 10, 'f', 1)
+                 .arg(percentile(latencies, 0.5) / 1000.0, 10, 'f', 2)
+                 .arg(percentile(latencies, 0.99) / 1000.0, 10, 'f', 2)
+                 .arg(percentile(latencies, 0.999) / 1000.0, 10, 'f', 2);
+    }
+
+    table += QString("Connections lost or refused: %1\n").arg(disconnections);
+
+    return table;
+}
+
+double LoadStatistics::percentile(const QVector<qint64> & sortedLatencies, double fraction)
+{
+    if(sortedLatencies.isEmpty())
+        return 0;
+
+    int index = qMin(sortedLatencies.size() - 1, int(fraction * sortedLatencies.size()));
+    return sortedLatencies.at(index);
+}
@@ -0,0 +1,33 @@
+#ifndef LOADSTATISTICS_H
+#define LOADSTATISTICS_H
+
+#include <QMap>
+#include <QVector>
+#include <QMutex>
+#include <QString>
+
+class LoadStatistics
+{
+private:
+    struct PacketStatistics
+    {
+        quint64 failures;
+        QVector<qint64> latencies;
+    };
+
+    QMap<int, PacketStatistics> packets;
+    quint64 disconnections;
+    mutable QMutex mutex;
+
+    static double percentile(const QVector<qint64> & sortedLatencies, double fraction);
+
+public:
+    LoadStatistics();
+    ~LoadStatistics() {}
+
+    void record(int packetId, qint64 latencyMicroseconds, bool failed);
+    void recordDisconnection();
+    QString report(qint64 elapsedMilliseconds) const;
+};
+
+#endif // LOADSTATISTICS_H
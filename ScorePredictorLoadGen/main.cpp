@@ -0,0 +1,128 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTimer>
+#include <cstdio>
+#include <loadgenerator.h>
+
+namespace
+{
+    QSharedPointer<RequestMix> createRequestMix(const QCommandLineParser & parser, const QString & mixDescription)
+    {
+        QString nickname = parser.value("nickname");
+        QString tournament = parser.value("tournament");
+        QString host = parser.value("tournament-host");
+        QString round = parser.value("round");
+        QStringList competitors = parser.value("match").split(':');
+        unsigned int tournamentId = parser.value("tournament-id").toUInt();
+
+        QHash<QString, QVariantList> requests;
+        requests["login"] << Packet::ID_LOGIN << nickname << parser.value("password");
+        requests["tournaments"] << Packet::ID_PULL_TOURNAMENTS << nickname << 20 << QString();
+        requests["matches"] << Packet::ID_PULL_MATCHES << tournament << host << round;
+        requests["prediction"] << Packet::ID_MAKE_PREDICTION << nickname << tournament << host << round
+                               << competitors.value(0) << competitors.value(1) << 1 << 0;
+        requests["rank"] << Packet::ID_DOWNLOAD_LEADERBOARD_RANK << tournamentId << nickname;
+        requests["page"] << Packet::ID_DOWNLOAD_LEADERBOARD_PAGE << tournamentId << 1 << 50;
+
+        QSharedPointer<RequestMix> mix(new RequestMix());
+
+        for(auto entry : mixDescription.split(',', QString::SkipEmptyParts))
+        {
+            QStringList nameAndWeight = entry.split('=');
+            bool weightOk = false;
+            int weight = nameAndWeight.value(1).toInt(&weightOk);
+
+            if(nameAndWeight.size() != 2 || !weightOk || !requests.contains(nameAndWeight[0]))
+            {
+                qCritical("Invalid entry of the request mix: %s", qPrintable(entry));
+                return QSharedPointer<RequestMix>();
+            }
+
+            mix->addRequest(weight, requests[nameAndWeight[0]]);
+        }
+
+        return mix;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ScorePredictorLoadGen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Opens many connections to the ScorePredictor server and replays a request mix.");
+    parser.addHelpOption();
+
+    QCommandLineOption addressOption(QStringList() << "a" << "address", "Address of the server.", "address",
+                                     "127.0.0.1");
+    QCommandLineOption portOption(QStringList() << "p" << "port", "Port of the server.", "port", "1024");
+    QCommandLineOption connectionsOption(QStringList() << "c" << "connections", "Number of connections.",
+                                         "connections", "100");
+    QCommandLineOption threadsOption(QStringList() << "t" << "threads", "Number of threads driving the connections.",
+                                     "threads", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption durationOption(QStringList() << "d" << "duration", "Length of the run in seconds.", "seconds",
+                                      "30");
+    QCommandLineOption mixOption(QStringList() << "m" << "mix",
+                                 "Weights of login, tournaments, matches, prediction, rank and page requests.", "mix",
+                                 "login=1,tournaments=2,matches=2,prediction=1,rank=1,page=1");
+    QCommandLineOption variantOption("variant", "Send QVariant encoded packets instead of the compact encoding.");
+    QCommandLineOption nicknameOption("nickname", "Nickname used in the requests.", "nickname", "loadgen");
+    QCommandLineOption passwordOption("password", "Password used to log in.", "password", "loadgen");
+    QCommandLineOption tournamentOption("tournament", "Tournament used in the requests.", "name", "Load test");
+    QCommandLineOption tournamentHostOption("tournament-host", "Host of the tournament.", "nickname", "loadgen");
+    QCommandLineOption tournamentIdOption("tournament-id", "Id of the tournament for leaderboard requests.", "id", "1");
+    QCommandLineOption roundOption("round", "Round used in the requests.", "name", "Round 1");
+    QCommandLineOption matchOption("match", "Competitors of the predicted match.", "first:second", "Home:Away");
+    parser.addOption(addressOption);
+    parser.addOption(portOption);
+    parser.addOption(connectionsOption);
+    parser.addOption(threadsOption);
+    parser.addOption(durationOption);
+    parser.addOption(mixOption);
+    parser.addOption(variantOption);
+    parser.addOption(nicknameOption);
+    parser.addOption(passwordOption);
+    parser.addOption(tournamentOption);
+    parser.addOption(tournamentHostOption);
+    parser.addOption(tournamentIdOption);
+    parser.addOption(roundOption);
+    parser.addOption(matchOption);
+    parser.process(app);
+
+    bool portOk = false;
+    bool connectionsOk = false;
+    bool threadsOk = false;
+    bool durationOk = false;
+    QHostAddress address(parser.value(addressOption));
+    quint16 port = parser.value(portOption).toUShort(&portOk);
+    int connections = parser.value(connectionsOption).toInt(&connectionsOk);
+    int threads = parser.value(threadsOption).toInt(&threadsOk);
+    int duration = parser.value(durationOption).toInt(&durationOk);
+
+    if(address.isNull() || !portOk || !connectionsOk || !threadsOk || !durationOk || connections < 1 || threads < 1 ||
+       duration < 1)
+    {
+        qCritical("Invalid address, port, number of connections, threads or duration.");
+        return -1;
+    }
+
+    QSharedPointer<RequestMix> mix = createRequestMix(parser, parser.value(mixOption));
+
+    if(!mix || mix->isEmpty())
+        return -1;
+
+    Packet::Encoding encoding = parser.isSet(variantOption) ? Packet::ENCODING_VARIANT : Packet::ENCODING_COMPACT;
+    LoadGenerator generator;
+    generator.start(address, port, connections, threads, mix, encoding);
+
+    qInfo("Running %d connections on %d threads for %d seconds.", connections, threads, duration);
+
+    QTimer::singleShot(duration * 1000, &app, [&generator]() {
+        generator.stop();
+        std::fputs(qPrintable(generator.report()), stdout);
+        QCoreApplication::quit();
+    });
+
+    return app.exec();
+}
@@ -0,0 +1,43 @@
+#include "requestmix.h"
+#include <QRandomGenerator>
+
+RequestMix::RequestMix()
+{
+    totalWeight = 0;
+}
+
+void RequestMix::addRequest(int weight, const QVariantList & request)
+{
+    if(weight <= 0 || request.isEmpty())
+        return;
+
+    WeightedRequest weightedRequest;
+    weightedRequest.weight = weight;
+    weightedRequest.request = request;
+
+    requests.append(weightedRequest);
+    totalWeight += weight;
+}
+
+QVariantList RequestMix::nextRequest() const
+{
+    if(requests.isEmpty())
+        return QVariantList();
+
+    int position = QRandomGenerator::global()->bounded(totalWeight);
+
+    for(auto & weightedRequest : requests)
+    {
+        if(position < weightedRequest.weight)
+            return weightedRequest.request;
+
+        position -= weightedRequest.weight;
+    }
+
+    return requests.last().request;
+}
+
+bool RequestMix::isEmpty() const
+{
+    return requests.isEmpty();
+}
@@ -0,0 +1,28 @@
+#ifndef REQUESTMIX_H
+#define REQUESTMIX_H
+
+#include <QVariantList>
+#include <QVector>
+
+class RequestMix
+{
+private:
+    struct WeightedRequest
+    {
+        int weight;
+        QVariantList request;
+    };
+
+    QVector<WeightedRequest> requests;
+    int totalWeight;
+
+public:
+    RequestMix();
+    ~RequestMix() {}
+
+    void addRequest(int weight, const QVariantList & request);
+    QVariantList nextRequest() const;
+    bool isEmpty() const;
+};
+
+#endif // REQUESTMIX_H
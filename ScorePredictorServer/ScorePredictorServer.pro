@@ -23,7 +23,21 @@ SOURCES += main.cpp \
     ../ScorePredictorClient/tournament.cpp \
     packetprocessor.cpp \
     ../ScorePredictorClient/match.cpp \
-    ../ScorePredictorClient/filestream.cpp
+    ../ScorePredictorClient/filestream.cpp \
+    leaderboardengine.cpp \
+    packetbuffer.cpp \
+    replychannel.cpp \
+    dbworker.cpp \
+    dbworkerpool.cpp \
+    connectionsload.cpp \
+    poolacceptor.cpp \
+    latencyhistogram.cpp \
+    servermetrics.cpp \
+    adminserver.cpp \
+    tournamentsearchindex.cpp \
+    avatarstore.cpp \
+    startingmessage.cpp \
+    responsecache.cpp
 
 RESOURCES += qml.qrc \
     ../ScorePredictorClient/assets.qrc
@@ -50,4 +64,18 @@ HEADERS += \
     ../ScorePredictorClient/tournament.h \
     packetprocessor.h \
     ../ScorePredictorClient/match.h \
-    ../ScorePredictorClient/filestream.h
+    ../ScorePredictorClient/filestream.h \
+    leaderboardengine.h \
+    packetbuffer.h \
+    replychannel.h \
+    dbworker.h \
+    dbworkerpool.h \
+    connectionsload.h \
+    poolacceptor.h \
+    latencyhistogram.h \
+    servermetrics.h \
+    adminserver.h \
+    tournamentsearchindex.h \
+    avatarstore.h \
+    startingmessage.h \
+    responsecache.h
@@ -0,0 +1,83 @@
+#include "adminserver.h"
+
+AdminServer::AdminServer(std::function<QString()> provider, QObject * parent) : QTcpServer(parent)
+{
+    metricsProvider = provider;
+    connect(this, &QTcpServer::newConnection, this, &AdminServer::connectionAccepted);
+}
+
+bool AdminServer::start(quint16 port)
+{
+    // Only reachable from the machine itself; the endpoint has no authentication.
+    return listen(QHostAddress::LocalHost, port);
+}
+
+void AdminServer::connectionAccepted()
+{
+    while(hasPendingConnections())
+    {
+        QTcpSocket * socket = nextPendingConnection();
+        requests.insert(socket, QByteArray());
+
+        connect(socket, &QTcpSocket::readyRead, this, &AdminServer::read);
+        connect(socket, &QTcpSocket::disconnected, this, &AdminServer::connectionClosed);
+    }
+}
+
+void AdminServer::read()
+{
+    QTcpSocket * socket = qobject_cast<QTcpSocket *>(sender());
+
+    if(!socket || !requests.contains(socket))
+        return;
+
+    QByteArray & request = requests[socket];
+    request.append(socket->readAll());
+
+    if(request.contains("\r\n\r\n"))
+        respond(socket, request);
+    else if(request.size() > MAX_REQUEST_SIZE)
+        respond(socket, QByteArray());
+}
+
+void AdminServer::respond(QTcpSocket * socket, const QByteArray & request)
+{
+    QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    QByteArray response;
+
+    if(requestLine.size() < 2)
+        response = createResponse("400 Bad Request", "Bad request\n");
+    else if(requestLine[0] != "GET")
+        response = createResponse("405 Method Not Allowed", "Only GET is supported\n");
+    else if(requestLine[1] != "/metrics")
+        response = createResponse("404 Not Found", "Not found\n");
+    else
+        response = createResponse("200 OK", metricsProvider().toUtf8());
+
+    requests.remove(socket);
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QByteArray AdminServer::createResponse(const QByteArray & status, const QByteArray & body)
+{
+    QByteArray response;
+    response.append("HTTP/1.1 " + status + "\r\n");
+    response.append("Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n");
+    response.append("Content-Length: " + QByteArray::number(body.size()) + "\r\n");
+    response.append("Connection: close\r\n\r\n");
+    response.append(body);
+
+    return response;
+}
+
+void AdminServer::connectionClosed()
+{
+    QTcpSocket * socket = qobject_cast<QTcpSocket *>(sender());
+
+    if(!socket)
+        return;
+
+    requests.remove(socket);
+    socket->deleteLater();
+}
@@ -0,0 +1,34 @@
+#ifndef ADMINSERVER_H
+#define ADMINSERVER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <functional>
+
+class AdminServer : public QTcpServer
+{
+    Q_OBJECT
+
+private:
+    QHash<QTcpSocket *, QByteArray> requests;
+    std::function<QString()> metricsProvider;
+
+    static const int MAX_REQUEST_SIZE = 8 * 1024;
+
+    void respond(QTcpSocket * socket, const QByteArray & request);
+    static QByteArray createResponse(const QByteArray & status, const QByteArray & body);
+
+private slots:
+    void connectionAccepted();
+    void read();
+    void connectionClosed();
+
+public:
+    explicit AdminServer(std::function<QString()> provider, QObject * parent = nullptr);
+    ~AdminServer() {}
+
+    bool start(quint16 port);
+};
+
+#endif // ADMINSERVER_H
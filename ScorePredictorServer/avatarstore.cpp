@@ -0,0 +1,256 @@
+#include "avatarstore.h"
+#include <QCryptographicHash>
+#include <QBuffer>
+#include <QImage>
+#include <QFile>
+#include <QSaveFile>
+#include <QRunnable>
+
+const int AvatarStore::THUMBNAIL_SIZES[NUMBER_OF_THUMBNAIL_SIZES] = {64, 128, 256};
+
+class ThumbnailTask : public QRunnable
+{
+private:
+    AvatarStore * store;
+    QString path;
+    QByteArray data;
+    QList<int> sizes;
+
+public:
+    ThumbnailTask(AvatarStore * store, const QString & path, const QByteArray & data, const QList<int> & sizes);
+    ~ThumbnailTask() {}
+
+    void run() override;
+};
+
+AvatarStore::AvatarStore(const QString & avatarsDirectory)
+{
+    directory = avatarsDirectory;
+    cache.setMaxCost(CACHE_CAPACITY);
+}
+
+bool AvatarStore::load(const QString & path, Avatar & avatar, int requestedSize)
+{
+    int thumbnailSize = findThumbnailSize(requestedSize);
+
+    if(thumbnailSize > 0 && loadFile(thumbnailPath(path, thumbnailSize), avatar))
+        return true;
+
+    if(!loadFile(path, avatar))
+        return false;
+
+    // Thumbnails appear shortly after an upload and are missing for avatars stored before they existed,
+    // so the full image is sent this time and the thumbnails are made for the next request.
+    if(thumbnailSize > 0)
+        generateThumbnails(path, avatar.data);
+
+    return true;
+}
+
+bool AvatarStore::loadFile(const QString & path, Avatar & avatar)
+{
+    {
+        QMutexLocker locker(&mutex);
+        Avatar * cachedAvatar = cache.object(path);
+
+        if(cachedAvatar)
+        {
+            avatar = *cachedAvatar;
+            return true;
+        }
+    }
+
+    // Stored avatars are already encoded, so the file is sent as it is instead of being decoded and encoded again.
+    QFile file(path);
+
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    avatar.data = file.readAll();
+    avatar.hash = findHash(avatar.data);
+
+    QMutexLocker locker(&mutex);
+    cache.insert(path, new Avatar(avatar), avatar.data.size());
+
+    return true;
+}
+
+bool AvatarStore::store(const QByteArray & uploadedData, QString & path)
+{
+    Avatar avatar;
+    avatar.data = normalize(uploadedData);
+
+    if(avatar.data.isEmpty())
+        return false;
+
+    avatar.hash = findHash(avatar.data);
+    path = directory + "/" + QString::fromLatin1(avatar.hash) + ".png";
+
+    // Files are named after their content, so an existing file already holds exactly these bytes.
+    if(!QFile::exists(path))
+    {
+        QFile file(path + ".tmp");
+
+        if(!file.open(QIODevice::WriteOnly) || file.write(avatar.data) != avatar.data.size())
+        {
+            file.remove();
+            return false;
+        }
+
+        file.close();
+
+        if(!QFile::rename(path + ".tmp", path) && !QFile::exists(path))
+        {
+            QFile::remove(path + ".tmp");
+            return false;
+        }
+    }
+
+    // The same image may have been stored before thumbnails existed, or lost them since.
+    generateThumbnails(path, avatar.data);
+
+    QMutexLocker locker(&mutex);
+    cache.insert(path, new Avatar(avatar), avatar.data.size());
+
+    return true;
+}
+
+void AvatarStore::remove(const QString & path)
+{
+    QFile::remove(path);
+
+    QMutexLocker locker(&mutex);
+    cache.remove(path);
+
+    for(int i=0; i<NUMBER_OF_THUMBNAIL_SIZES; i++)
+    {
+        QString thumbnail = thumbnailPath(path, THUMBNAIL_SIZES[i]);
+        QFile::remove(thumbnail);
+        cache.remove(thumbnail);
+    }
+}
+
+void AvatarStore::generateThumbnails(const QString & path, const QByteArray & data)
+{
+    QList<int> sizes;
+
+    for(int i=0; i<NUMBER_OF_THUMBNAIL_SIZES; i++)
+    {
+        if(!QFile::exists(thumbnailPath(path, THUMBNAIL_SIZES[i])))
+            sizes << THUMBNAIL_SIZES[i];
+    }
+
+    if(sizes.isEmpty())
+        return;
+
+    {
+        QMutexLocker locker(&mutex);
+
+        if(pendingThumbnails.contains(path))
+            return;
+
+        pendingThumbnails.insert(path);
+    }
+
+    // Scaling runs on the store's own pool, the worker that handled the request replies straight away.
+    thumbnailPool.start(new ThumbnailTask(this, path, data, sizes));
+}
+
+void AvatarStore::finishThumbnails(const QString & path)
+{
+    QMutexLocker locker(&mutex);
+    pendingThumbnails.remove(path);
+}
+
+int AvatarStore::findThumbnailSize(int requestedSize)
+{
+    if(requestedSize <= 0)
+        return 0;
+
+    for(int i=0; i<NUMBER_OF_THUMBNAIL_SIZES; i++)
+    {
+        if(THUMBNAIL_SIZES[i] >= requestedSize)
+            return THUMBNAIL_SIZES[i];
+    }
+
+    return 0;
+}
+
+QString AvatarStore::thumbnailPath(const QString & path, int size)
+{
+    int suffixIndex = path.lastIndexOf('.');
+
+    if(suffixIndex <= path.lastIndexOf('/'))
+        suffixIndex = path.size();
+
+    return path.left(suffixIndex) + "_" + QString::number(size) + ".png";
+}
+
+QByteArray AvatarStore::normalize(const QByteArray & uploadedData)
+{
+    QImage image;
+
+    if(!image.loadFromData(uploadedData) || image.isNull())
+        return QByteArray();
+
+    if(image.width() > MAX_DIMENSION || image.height() > MAX_DIMENSION)
+        image = image.scaled(MAX_DIMENSION, MAX_DIMENSION, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    QByteArray encodedData;
+    QBuffer buffer(&encodedData);
+
+    if(!image.save(&buffer, "PNG"))
+        return QByteArray();
+
+    return encodedData;
+}
+
+QByteArray AvatarStore::findHash(const QByteArray & data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex();
+}
+
+ThumbnailTask::ThumbnailTask(AvatarStore * store, const QString & path, const QByteArray & data,
+                             const QList<int> & sizes)
+{
+    this->store = store;
+    this->path = path;
+    this->data = data;
+    this->sizes = sizes;
+}
+
+void ThumbnailTask::run()
+{
+    QImage image;
+
+    if(image.loadFromData(data))
+    {
+        for(int size : sizes)
+        {
+            QString thumbnail = AvatarStore::thumbnailPath(path, size);
+
+            if(QFile::exists(thumbnail))
+                continue;
+
+            QImage scaledImage = image;
+
+            if(image.width() > size || image.height() > size)
+                scaledImage = image.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+            // QSaveFile renames into place on commit, so a reader never sees a half written thumbnail.
+            QSaveFile file(thumbnail);
+
+            if(!file.open(QIODevice::WriteOnly) || !scaledImage.save(&file, "PNG") || !QFile::exists(path))
+            {
+                file.cancelWriting();
+                continue;
+            }
+
+            // remove() may delete the avatar between the check and the commit, a thumbnail must not outlive it.
+            if(file.commit() && !QFile::exists(path))
+                QFile::remove(thumbnail);
+        }
+    }
+
+    store->finishThumbnails(path);
+}
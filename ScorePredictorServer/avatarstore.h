@@ -0,0 +1,52 @@
+#ifndef AVATARSTORE_H
+#define AVATARSTORE_H
+
+#include <QCache>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+#include <QByteArray>
+#include <QString>
+
+struct Avatar
+{
+    QByteArray data;
+    QByteArray hash;
+};
+
+class AvatarStore
+{
+private:
+    QCache<QString, Avatar> cache;
+    QString directory;
+    QSet<QString> pendingThumbnails;
+    mutable QMutex mutex;
+    QThreadPool thumbnailPool;
+
+    static const int CACHE_CAPACITY = 32 * 1024 * 1024;
+    static const int MAX_DIMENSION = 512;
+    static const int NUMBER_OF_THUMBNAIL_SIZES = 3;
+    static const int THUMBNAIL_SIZES[NUMBER_OF_THUMBNAIL_SIZES];
+
+    bool loadFile(const QString & path, Avatar & avatar);
+    void generateThumbnails(const QString & path, const QByteArray & data);
+    void finishThumbnails(const QString & path);
+
+    static int findThumbnailSize(int requestedSize);
+    static QByteArray findHash(const QByteArray & data);
+
+    friend class ThumbnailTask;
+
+public:
+    explicit AvatarStore(const QString & avatarsDirectory = QString("avatars"));
+    ~AvatarStore() {}
+
+    bool load(const QString & path, Avatar & avatar, int requestedSize = 0);
+    bool store(const QByteArray & uploadedData, QString & path);
+    void remove(const QString & path);
+
+    static QByteArray normalize(const QByteArray & uploadedData);
+    static QString thumbnailPath(const QString & path, int size);
+};
+
+#endif // AVATARSTORE_H
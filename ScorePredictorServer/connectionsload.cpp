@@ -0,0 +1,68 @@
+#include "connectionsload.h"
+
+ConnectionsLoad::ConnectionsLoad()
+{
+    connections = 0;
+    pendingRequests = 0;
+    busyPermille = 0;
+    busyTime = 0;
+}
+
+void ConnectionsLoad::connectionAccepted()
+{
+    connections.fetchAndAddRelaxed(1);
+}
+
+void ConnectionsLoad::connectionClosed()
+{
+    connections.fetchAndSubRelaxed(1);
+}
+
+void ConnectionsLoad::requestStarted()
+{
+    pendingRequests.fetchAndAddRelaxed(1);
+}
+
+void ConnectionsLoad::requestFinished()
+{
+    pendingRequests.fetchAndSubRelaxed(1);
+}
+
+void ConnectionsLoad::addBusyTime(qint64 nanoseconds)
+{
+    busyTime.fetchAndAddRelaxed(nanoseconds);
+}
+
+void ConnectionsLoad::publishBusyTime(int intervalMilliseconds)
+{
+    if(intervalMilliseconds <= 0)
+        return;
+
+    qint64 sample = busyTime.fetchAndStoreRelaxed(0) / (qint64(intervalMilliseconds) * 1000);
+
+    if(sample > 1000)
+        sample = 1000;
+
+    // Half of the previous value is kept, so a single quiet interval doesn't hide a busy thread.
+    busyPermille.store((busyPermille.load() + int(sample)) / 2);
+}
+
+int ConnectionsLoad::getConnections() const
+{
+    return connections.load();
+}
+
+int ConnectionsLoad::getPendingRequests() const
+{
+    return pendingRequests.load();
+}
+
+int ConnectionsLoad::getBusyPermille() const
+{
+    return busyPermille.load();
+}
+
+int ConnectionsLoad::score() const
+{
+    return getConnections() * CONNECTION_WEIGHT + getPendingRequests() * REQUEST_WEIGHT + getBusyPermille();
+}
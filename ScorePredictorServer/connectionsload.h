@@ -0,0 +1,35 @@
+#ifndef CONNECTIONSLOAD_H
+#define CONNECTIONSLOAD_H
+
+#include <QAtomicInteger>
+
+class ConnectionsLoad
+{
+private:
+    QAtomicInt connections;
+    QAtomicInt pendingRequests;
+    QAtomicInt busyPermille;
+    QAtomicInteger<qint64> busyTime;
+
+public:
+    ConnectionsLoad();
+    ~ConnectionsLoad() {}
+
+    void connectionAccepted();
+    void connectionClosed();
+    void requestStarted();
+    void requestFinished();
+
+    void addBusyTime(qint64 nanoseconds);
+    void publishBusyTime(int intervalMilliseconds);
+
+    int getConnections() const;
+    int getPendingRequests() const;
+    int getBusyPermille() const;
+    int score() const;
+
+    static const int CONNECTION_WEIGHT = 10;
+    static const int REQUEST_WEIGHT = 40;
+};
+
+#endif // CONNECTIONSLOAD_H
@@ -3,16 +3,28 @@
 const QString DbConnection::DATABASE_NAME = QString("data/database.db");
 const QString DbConnection::DRIVER_NAME = QString("QSQLITE");
 const QString DbConnection::INITIAL_CONNECTION_NAME = QString("InitialConnection");
+const int DbConnection::HEARTBEAT_INTERVAL = 5000;
 QStringList DbConnection::connectionsList = QStringList();
+QAtomicInteger<quint64> DbConnection::totalStatementCacheHits(0);
+QAtomicInteger<quint64> DbConnection::totalStatementCacheMisses(0);
 
 DbConnection::DbConnection(QObject * parent) : QObject(parent)
 {
     name = INITIAL_CONNECTION_NAME;
+    statementCacheHits = 0;
+    statementCacheMisses = 0;
+    healthy = false;
+    reconnecting = false;
+    writeAheadLogging = false;
+
+    heartbeatTimer = new QTimer(this);
+    heartbeatTimer->setInterval(HEARTBEAT_INTERVAL);
+    QObject::connect(heartbeatTimer, &QTimer::timeout, this, &DbConnection::heartbeat);
 }
 
 bool DbConnection::connect(const QString & connectionName, const QString & databaseName, const QString & driver)
 {
-    if(isConnected() || connectionName == INITIAL_CONNECTION_NAME)
+    if(connection.isOpen() || connectionName == INITIAL_CONNECTION_NAME)
         return false;
 
     if(connectionsList.contains(connectionName))
@@ -23,9 +35,14 @@ bool DbConnection::connect(const QString & connectionName, const QString & datab
 
     connection = QSqlDatabase::addDatabase(driver, connectionName);
     connection.setDatabaseName(databaseName);
+    connection.setConnectOptions(connectOptions);
 
     if(connection.open())
+    {
+        healthy = true;
+        heartbeatTimer->start();
         return true;
+    }
 
     clearConnection();
     return false;
@@ -33,27 +50,99 @@ bool DbConnection::connect(const QString & connectionName, const QString & datab
 
 void DbConnection::close()
 {
+    heartbeatTimer->stop();
+    healthy = false;
+    preparedStatements.clear();
     connection.close();
     clearConnection();
 }
 
-bool DbConnection::isConnected()
+bool DbConnection::isConnected() const
+{
+    return healthy;
+}
+
+void DbConnection::reportError(const QSqlError & error)
+{
+    if(!healthy || reconnecting)
+        return;
+
+    // Only errors that point at the connection itself are worth a reconnect, not failed constraints.
+    // Extended codes such as SQLITE_IOERR_SHORT_READ keep the primary code in their low byte.
+    int nativeCode = error.nativeErrorCode().toInt() & PRIMARY_RESULT_CODE_MASK;
+
+    if(error.type() == QSqlError::ConnectionError || nativeCode == ERROR_IO || nativeCode == ERROR_CORRUPT ||
+       nativeCode == ERROR_CANT_OPEN || nativeCode == ERROR_NOT_A_DATABASE)
+    {
+        healthy = false;
+        QTimer::singleShot(0, this, &DbConnection::heartbeat);
+    }
+}
+
+void DbConnection::heartbeat()
 {
+    if(!connection.isValid())
+        return;
+
     if(connection.isOpen())
     {
         QSqlQuery query(connection);
-        query.prepare("SELECT 1 FROM user");
 
-        if(query.exec())
-            return true;
+        if(query.exec("SELECT 1"))
+        {
+            healthy = true;
+            return;
+        }
     }
 
-    return false;
+    reconnect();
+}
+
+bool DbConnection::reconnect()
+{
+    // Cached statements belong to the old handle and must be gone before it closes. Paused reply streams hold
+    // no statements, they read every page with a fresh query and simply continue on the reopened connection.
+    reconnecting = true;
+    preparedStatements.clear();
+    connection.close();
+    healthy = connection.open();
+
+    // Pragmas are per connection, without this a reopened connection would silently fall back to synchronous=FULL.
+    if(healthy && writeAheadLogging)
+        healthy = applyWriteAheadLogging();
+
+    reconnecting = false;
+
+    return healthy;
 }
 
 void DbConnection::setConnectOptions(const QString & options)
 {
-    connection.setConnectOptions(options);
+    connectOptions = options;
+
+    if(connection.isValid())
+        connection.setConnectOptions(options);
+}
+
+bool DbConnection::enableWriteAheadLogging()
+{
+    writeAheadLogging = true;
+
+    return applyWriteAheadLogging();
+}
+
+bool DbConnection::applyWriteAheadLogging()
+{
+    if(!connection.isOpen())
+        return false;
+
+    QSqlQuery query(connection);
+
+    if(!query.exec("PRAGMA journal_mode=WAL") || !query.next() ||
+       query.value(0).toString().compare("wal", Qt::CaseInsensitive) != 0)
+        return false;
+
+    return query.exec("PRAGMA synchronous=NORMAL");
 }
 
 void DbConnection::clearConnection()
@@ -77,3 +166,57 @@ QSqlDatabase DbConnection::getConnection() const
 {
     return connection;
 }
+
+bool DbConnection::takePreparedStatement(int statementId, QSqlQuery & statement)
+{
+    if(!preparedStatements.contains(statementId))
+    {
+        statementCacheMisses++;
+        totalStatementCacheMisses.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    statement = preparedStatements.take(statementId);
+    statementCacheHits++;
+    totalStatementCacheHits.fetchAndAddRelaxed(1);
+
+    return true;
+}
+
+void DbConnection::returnPreparedStatement(int statementId, const QSqlQuery & statement)
+{
+    if(!connection.isOpen() || preparedStatements.contains(statementId))
+        return;
+
+    preparedStatements.insert(statementId, statement);
+}
+
+quint64 DbConnection::getStatementCacheHits() const
+{
+    return statementCacheHits;
+}
+
+quint64 DbConnection::getStatementCacheMisses() const
+{
+    return statementCacheMisses;
+}
+
+double DbConnection::statementCacheHitRate() const
+{
+    quint64 lookups = statementCacheHits + statementCacheMisses;
+
+    if(lookups == 0)
+        return 0.0;
+
+    return double(statementCacheHits) / lookups;
+}
+
+quint64 DbConnection::getTotalStatementCacheHits()
+{
+    return totalStatementCacheHits.load();
+}
+
+quint64 DbConnection::getTotalStatementCacheMisses()
+{
+    return totalStatementCacheMisses.load();
+}
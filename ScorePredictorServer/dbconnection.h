@@ -5,6 +5,9 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QHash>
+#include <QAtomicInteger>
+#include <QTimer>
 
 class DbConnection : public QObject
 {
@@ -13,14 +16,36 @@ class DbConnection : public QObject
 private:
     QSqlDatabase connection;
     QString name;
+    QString connectOptions;
+    QTimer * heartbeatTimer;
+    bool healthy;
+    bool reconnecting;
+    bool writeAheadLogging;
+    QHash<int, QSqlQuery> preparedStatements;
+    quint64 statementCacheHits;
+    quint64 statementCacheMisses;
 
     static QStringList connectionsList;
+    static QAtomicInteger<quint64> totalStatementCacheHits;
+    static QAtomicInteger<quint64> totalStatementCacheMisses;
 
     const static QString DATABASE_NAME;
     const static QString DRIVER_NAME;
     const static QString INITIAL_CONNECTION_NAME;
+    const static int HEARTBEAT_INTERVAL;
+
+    static const int ERROR_IO = 10;
+    static const int ERROR_CORRUPT = 11;
+    static const int ERROR_CANT_OPEN = 14;
+    static const int ERROR_NOT_A_DATABASE = 26;
+    static const int PRIMARY_RESULT_CODE_MASK = 0xFF;
 
     void clearConnection();
+    bool reconnect();
+    bool applyWriteAheadLogging();
+
+private slots:
+    void heartbeat();
 
 public:
     explicit DbConnection(QObject * parent = nullptr);
@@ -30,10 +55,21 @@ public:
                  const QString & driver = DRIVER_NAME);
     void close();
     void setConnectOptions(const QString & options = QString());
+    bool enableWriteAheadLogging();
 
     static int numberOfOpenedConnections();
-    bool isConnected();
+    bool isConnected() const;
+    void reportError(const QSqlError & error);
     QSqlDatabase getConnection() const;
+
+    bool takePreparedStatement(int statementId, QSqlQuery & statement);
+    void returnPreparedStatement(int statementId, const QSqlQuery & statement);
+    quint64 getStatementCacheHits() const;
+    quint64 getStatementCacheMisses() const;
+    double statementCacheHitRate() const;
+
+    static quint64 getTotalStatementCacheHits();
+    static quint64 getTotalStatementCacheMisses();
 };
 
 #endif // DBCONNECTION_H
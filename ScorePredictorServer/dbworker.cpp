@@ -0,0 +1,177 @@
+#include "dbworker.h"
+#include <dbworkerpool.h>
+#include <QThread>
+#include <QElapsedTimer>
+
+QMutex DbWorker::mutex;
+const int DbWorker::GROUP_COMMIT_WINDOW = 2;
+const int DbWorker::GROUP_COMMIT_LIMIT = 256;
+const int DbWorker::SETTLEMENT_INTERVAL = 5000;
+
+DbWorker::DbWorker(DbWorkerPool * pool, const QString & databaseName, QSharedPointer<LeaderboardEngine> leaderboards,
+                   QSharedPointer<TournamentSearchIndex> tournamentSearch, QSharedPointer<AvatarStore> avatars,
+                   QSharedPointer<ResponseCache> responses, bool writer, QObject * parent) : QObject(parent)
+{
+    workerPool = pool;
+    this->databaseName = databaseName;
+    this->leaderboards = leaderboards;
+    this->tournamentSearch = tournamentSearch;
+    this->avatars = avatars;
+    this->responses = responses;
+    this->writer = writer;
+    packetProcessor = nullptr;
+    settlementTimer = nullptr;
+}
+
+bool DbWorker::isWriter() const
+{
+    return writer;
+}
+
+void DbWorker::init()
+{
+    if(dbConnection)
+        return;
+
+    QMutexLocker locker(&mutex);
+
+    dbConnection = QSharedPointer<DbConnection>(new DbConnection(this));
+
+    // All mutations go through the writer, so the readers cannot write even by accident.
+    if(writer)
+        dbConnection->setConnectOptions("QSQLITE_BUSY_TIMEOUT=10000;");
+    else
+        dbConnection->setConnectOptions("QSQLITE_BUSY_TIMEOUT=10000;QSQLITE_OPEN_READONLY");
+
+    QString connectionName = QString::number(dbConnection->numberOfOpenedConnections());
+
+    if(databaseName.isEmpty())
+        dbConnection->connect(connectionName);
+    else
+        dbConnection->connect(connectionName, databaseName);
+
+    packetProcessor = new Server::PacketProcessor(dbConnection, leaderboards, tournamentSearch, avatars, responses, this);
+
+    if(writer)
+    {
+        // The journal mode is stored in the database file, so the read-only readers open it in WAL as well.
+        dbConnection->enableWriteAheadLogging();
+
+        Query query(dbConnection);
+        query.prepareLeaderboardSchema();
+
+        // Rounds are settled once their prediction deadlines pass, between the writer's request batches.
+        settlementTimer = new QTimer(this);
+        connect(settlementTimer, &QTimer::timeout, this, &DbWorker::settleScores);
+        settlementTimer->start(SETTLEMENT_INTERVAL);
+        settleScores();
+    }
+}
+
+void DbWorker::processRequests()
+{
+    DbRequest request;
+
+    while(workerPool->takeRequest(this, request))
+    {
+        recordQueueTime(request);
+
+        if(writer && DbWorkerPool::isGroupCommitRequest(request.packet.getUnserializedData()[0].toInt()))
+            processRequestGroup(request);
+        else
+            packetProcessor->processRequest(request.packet, request.channel);
+
+        request = DbRequest();
+    }
+}
+
+void DbWorker::settleScores()
+{
+    if(packetProcessor)
+        packetProcessor->settleScores();
+}
+
+void DbWorker::processRequestGroup(const DbRequest & firstRequest)
+{
+    QList<DbRequest> group;
+    DbRequest request;
+    QElapsedTimer timer;
+
+    group << firstRequest;
+    timer.start();
+
+    while(group.size() < GROUP_COMMIT_LIMIT)
+    {
+        qint64 remainingTime = GROUP_COMMIT_WINDOW - timer.elapsed();
+
+        if(remainingTime <= 0 || !workerPool->takeGroupCommitRequest(request, remainingTime))
+            break;
+
+        recordQueueTime(request);
+        group << request;
+    }
+
+    QSqlDatabase database = dbConnection->getConnection();
+
+    // Without a transaction every statement autocommits, so the group can only be run once, request by request.
+    if(group.size() == 1 || !database.transaction())
+    {
+        for(auto groupedRequest : group)
+            packetProcessor->processRequest(groupedRequest.packet, groupedRequest.channel);
+
+        return;
+    }
+
+    // Replies are held back until the whole group is durable, so no client is told about a write that is lost.
+    packetProcessor->setReplyBuffering(true);
+
+    for(auto groupedRequest : group)
+        packetProcessor->processRequest(groupedRequest.packet, groupedRequest.channel);
+
+    if(database.commit())
+    {
+        packetProcessor->flushBufferedReplies();
+        return;
+    }
+
+    // Nothing of the group reached the database, so each request is replayed on its own.
+    database.rollback();
+    packetProcessor->discardBufferedReplies();
+
+    for(auto groupedRequest : group)
+        packetProcessor->processRequest(groupedRequest.packet, groupedRequest.channel);
+}
+
+void DbWorker::recordQueueTime(const DbRequest & request)
+{
+    ServerMetrics::recordStage(request.packet.getUnserializedData()[0].toInt(), ServerMetrics::STAGE_QUEUE,
+                               request.submitTime);
+}
+
+void DbWorker::resumeReplies(quint64 connectionId)
+{
+    if(packetProcessor)
+        packetProcessor->resumeChunkStream(connectionId);
+}
+
+void DbWorker::dropReplies(quint64 connectionId)
+{
+    if(packetProcessor)
+        packetProcessor->dropChunkStream(connectionId);
+}
+
+void DbWorker::close()
+{
+    QMutexLocker locker(&mutex);
+
+    if(settlementTimer)
+        settlementTimer->stop();
+
+    delete packetProcessor;
+    packetProcessor = nullptr;
+
+    if(dbConnection)
+        dbConnection->close();
+
+    thread()->quit();
+}
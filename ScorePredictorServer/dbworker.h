@@ -0,0 +1,69 @@
+#ifndef DBWORKER_H
+#define DBWORKER_H
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QTimer>
+#include <packet.h>
+#include <replychannel.h>
+#include <dbconnection.h>
+#include <leaderboardengine.h>
+#include <tournamentsearchindex.h>
+#include <avatarstore.h>
+#include <responsecache.h>
+#include <packetprocessor.h>
+#include <servermetrics.h>
+
+class DbWorkerPool;
+
+struct DbRequest
+{
+    Packet packet;
+    QSharedPointer<ReplyChannel> channel;
+    qint64 submitTime;
+};
+
+class DbWorker : public QObject
+{
+    Q_OBJECT
+
+private:
+    DbWorkerPool * workerPool;
+    QString databaseName;
+    QSharedPointer<LeaderboardEngine> leaderboards;
+    QSharedPointer<TournamentSearchIndex> tournamentSearch;
+    QSharedPointer<AvatarStore> avatars;
+    QSharedPointer<ResponseCache> responses;
+    QSharedPointer<DbConnection> dbConnection;
+    Server::PacketProcessor * packetProcessor;
+    QTimer * settlementTimer;
+    bool writer;
+    static QMutex mutex;
+
+    const static int GROUP_COMMIT_WINDOW;
+    const static int GROUP_COMMIT_LIMIT;
+    const static int SETTLEMENT_INTERVAL;
+
+    void processRequestGroup(const DbRequest & firstRequest);
+    static void recordQueueTime(const DbRequest & request);
+
+public:
+    explicit DbWorker(DbWorkerPool * pool, const QString & databaseName,
+                      QSharedPointer<LeaderboardEngine> leaderboards, QSharedPointer<TournamentSearchIndex> tournamentSearch,
+                      QSharedPointer<AvatarStore> avatars, QSharedPointer<ResponseCache> responses,
+                      bool writer = false, QObject * parent = nullptr);
+    ~DbWorker() {}
+
+    bool isWriter() const;
+
+public slots:
+    void init();
+    void processRequests();
+    void settleScores();
+    void resumeReplies(quint64 connectionId);
+    void dropReplies(quint64 connectionId);
+    void close();
+};
+
+#endif // DBWORKER_H
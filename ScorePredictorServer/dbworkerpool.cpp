@@ -0,0 +1,322 @@
+#include "dbworkerpool.h"
+
+DbWorkerPool::DbWorkerPool(QSharedPointer<LeaderboardEngine> leaderboards,
+                           QSharedPointer<TournamentSearchIndex> tournamentSearch, QSharedPointer<AvatarStore> avatars,
+                           QSharedPointer<ResponseCache> responses, QObject * parent) : QObject(parent)
+{
+    this->leaderboards = leaderboards;
+    this->tournamentSearch = tournamentSearch;
+    this->avatars = avatars;
+    this->responses = responses;
+    writer = nullptr;
+    writerIdle = false;
+    queuedReadRequests = 0;
+    numberOfReaders = QThread::idealThreadCount();
+    queueCapacity = 1024;
+    running = false;
+}
+
+DbWorkerPool::~DbWorkerPool()
+{
+    stop();
+}
+
+void DbWorkerPool::start()
+{
+    if(running)
+        return;
+
+    running = true;
+
+    // All mutations go through the single writer; with WAL the readers never wait for it.
+    writer = createWorker(true);
+    writerIdle = true;
+
+    // The readers open the database read-only, so the writer has to switch it to WAL before they connect.
+    QMetaObject::invokeMethod(writer, "init", Qt::BlockingQueuedConnection);
+
+    for(int i=0; i<numberOfReaders; i++)
+    {
+        QSharedPointer<ReaderQueue> queue(new ReaderQueue());
+        queue->worker = createWorker(false);
+
+        readerQueues.append(queue);
+        idleReaders.append(queue->worker);
+    }
+}
+
+DbWorker * DbWorkerPool::createWorker(bool writing)
+{
+    QThread * workerThread = new QThread(this);
+    DbWorker * worker = new DbWorker(this, databaseName, leaderboards, tournamentSearch, avatars, responses, writing);
+
+    worker->moveToThread(workerThread);
+    connect(workerThread, &QThread::started, worker, &DbWorker::init);
+    connect(workerThread, &QThread::finished, worker, &QObject::deleteLater);
+
+    mutex.lock();
+    workers.append(worker);
+    workerThreads.append(workerThread);
+    mutex.unlock();
+
+    workerThread->start();
+
+    return worker;
+}
+
+void DbWorkerPool::stop()
+{
+    if(!running)
+        return;
+
+    QList<DbWorker *> stoppedWorkers;
+
+    {
+        QMutexLocker locker(&mutex);
+        running = false;
+        writeRequests.clear();
+        idleReaders.clear();
+        writer = nullptr;
+        writerIdle = false;
+        stoppedWorkers = workers;
+        workers.clear();
+        writeRequestArrived.wakeAll();
+    }
+
+    for(auto worker : stoppedWorkers)
+        QMetaObject::invokeMethod(worker, "close", Qt::QueuedConnection);
+
+    for(auto workerThread : workerThreads)
+        workerThread->wait();
+
+    qDeleteAll(workerThreads);
+    workerThreads.clear();
+    clearReaderQueues();
+}
+
+void DbWorkerPool::clearReaderQueues()
+{
+    for(auto queue : readerQueues)
+    {
+        QMutexLocker locker(&queue->mutex);
+        queue->requests.clear();
+    }
+
+    readerQueues.clear();
+    queuedReadRequests = 0;
+}
+
+bool DbWorkerPool::submit(const Packet & packet, QSharedPointer<ReplyChannel> channel)
+{
+    DbWorker * worker = nullptr;
+    DbRequest request;
+    request.packet = packet;
+    request.channel = channel;
+    request.submitTime = ServerMetrics::now();
+
+    if(isWriteRequest(packet.getUnserializedData()[0].toInt()))
+    {
+        QMutexLocker locker(&mutex);
+
+        if(!running || queuedReadRequests.load() + writeRequests.size() >= queueCapacity)
+            return false;
+
+        writeRequests.enqueue(request);
+        writeRequestArrived.wakeAll();
+
+        if(writerIdle)
+        {
+            writerIdle = false;
+            worker = writer;
+        }
+    }
+    else
+    {
+        QMutexLocker locker(&mutex);
+
+        if(!running || queuedReadRequests.load() + writeRequests.size() >= queueCapacity)
+            return false;
+
+        // A connection always lands on the same home queue, idle readers steal from the busy ones.
+        QSharedPointer<ReaderQueue> home = readerQueues.at(channel->getConnectionId() % readerQueues.size());
+
+        home->mutex.lock();
+        home->requests.append(request);
+        home->mutex.unlock();
+        queuedReadRequests.fetchAndAddOrdered(1);
+
+        if(idleReaders.removeOne(home->worker))
+            worker = home->worker;
+        else if(!idleReaders.isEmpty())
+            worker = idleReaders.takeLast();
+    }
+
+    if(worker)
+        QMetaObject::invokeMethod(worker, "processRequests", Qt::QueuedConnection);
+
+    return true;
+}
+
+bool DbWorkerPool::takeRequest(DbWorker * worker, DbRequest & request)
+{
+    if(!worker->isWriter())
+        return takeReadRequest(worker, request);
+
+    QMutexLocker locker(&mutex);
+
+    if(running && !writeRequests.isEmpty())
+    {
+        request = writeRequests.dequeue();
+        return true;
+    }
+
+    if(running)
+        writerIdle = true;
+
+    return false;
+}
+
+bool DbWorkerPool::takeReadRequest(DbWorker * worker, DbRequest & request)
+{
+    while(true)
+    {
+        int ownIndex = 0;
+
+        while(ownIndex < readerQueues.size() && readerQueues.at(ownIndex)->worker != worker)
+            ownIndex++;
+
+        // The own queue is served from the front, the others are robbed from the back.
+        for(int i=0; i<readerQueues.size(); i++)
+        {
+            QSharedPointer<ReaderQueue> queue = readerQueues.at((ownIndex + i) % readerQueues.size());
+            QMutexLocker locker(&queue->mutex);
+
+            if(queue->requests.isEmpty())
+                continue;
+
+            request = i == 0 ? queue->requests.takeFirst() : queue->requests.takeLast();
+            queuedReadRequests.fetchAndSubOrdered(1);
+            return true;
+        }
+
+        QMutexLocker locker(&mutex);
+
+        if(!running)
+            return false;
+
+        // A request submitted during the scan is counted before submit() looks for idle readers.
+        if(queuedReadRequests.load() > 0)
+            continue;
+
+        if(!idleReaders.contains(worker))
+            idleReaders.append(worker);
+
+        return false;
+    }
+}
+
+bool DbWorkerPool::takeGroupCommitRequest(DbRequest & request, qint64 timeout)
+{
+    QMutexLocker locker(&mutex);
+
+    if(running && writeRequests.isEmpty())
+        writeRequestArrived.wait(&mutex, timeout);
+
+    // Only the head of the queue may join the group, so writes still commit in arrival order.
+    if(!running || writeRequests.isEmpty() ||
+       !isGroupCommitRequest(writeRequests.head().packet.getUnserializedData()[0].toInt()))
+        return false;
+
+    request = writeRequests.dequeue();
+    return true;
+}
+
+bool DbWorkerPool::isGroupCommitRequest(int packetId)
+{
+    switch(packetId)
+    {
+    case Packet::ID_MAKE_PREDICTION:
+    case Packet::ID_MAKE_PREDICTION_BY_ID:
+    case Packet::ID_UPDATE_PREDICTION:
+    case Packet::ID_UPDATE_PREDICTION_BY_ID:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool DbWorkerPool::isWriteRequest(int packetId)
+{
+    switch(packetId)
+    {
+    case Packet::ID_REGISTER:
+    case Packet::ID_UPDATE_USER_PROFILE_DESCRIPTION:
+    case Packet::ID_UPDATE_USER_PROFILE_AVATAR:
+    case Packet::ID_CREATE_TOURNAMENT:
+    case Packet::ID_JOIN_TOURNAMENT:
+    case Packet::ID_JOIN_TOURNAMENT_PASSWORD:
+    case Packet::ID_FINISH_TOURNAMENT:
+    case Packet::ID_ADD_NEW_ROUND:
+    case Packet::ID_CREATE_MATCH:
+    case Packet::ID_DELETE_MATCH:
+    case Packet::ID_UPDATE_MATCH_SCORE:
+    case Packet::ID_UPDATE_MATCH_SCORE_BY_ID:
+    case Packet::ID_MAKE_PREDICTION:
+    case Packet::ID_MAKE_PREDICTION_BY_ID:
+    case Packet::ID_UPDATE_PREDICTION:
+    case Packet::ID_UPDATE_PREDICTION_BY_ID:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void DbWorkerPool::connectionDrained(quint64 connectionId)
+{
+    QMutexLocker locker(&mutex);
+
+    for(auto worker : workers)
+        QMetaObject::invokeMethod(worker, [worker, connectionId]() { worker->resumeReplies(connectionId); },
+                                  Qt::QueuedConnection);
+}
+
+void DbWorkerPool::connectionClosed(quint64 connectionId)
+{
+    QMutexLocker locker(&mutex);
+
+    for(auto worker : workers)
+        QMetaObject::invokeMethod(worker, [worker, connectionId]() { worker->dropReplies(connectionId); },
+                                  Qt::QueuedConnection);
+}
+
+int DbWorkerPool::getQueueDepth() const
+{
+    QMutexLocker locker(&mutex);
+    return queuedReadRequests.load() + writeRequests.size();
+}
+
+void DbWorkerPool::setDatabaseName(const QString & value)
+{
+    if(running)
+        return;
+
+    databaseName = value;
+}
+
+void DbWorkerPool::setNumberOfWorkers(int value)
+{
+    if(running || value < 1)
+        return;
+
+    numberOfReaders = value;
+}
+
+void DbWorkerPool::setQueueCapacity(int value)
+{
+    if(running || value < 1)
+        return;
+
+    queueCapacity = value;
+}
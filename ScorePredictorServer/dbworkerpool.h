@@ -0,0 +1,72 @@
+#ifndef DBWORKERPOOL_H
+#define DBWORKERPOOL_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+#include <QAtomicInteger>
+#include <dbworker.h>
+
+class DbWorkerPool : public QObject
+{
+    Q_OBJECT
+
+private:
+    struct ReaderQueue
+    {
+        DbWorker * worker;
+        QMutex mutex;
+        QList<DbRequest> requests;
+    };
+
+    QList<DbWorker *> workers;
+    QList<QThread *> workerThreads;
+    QList<DbWorker *> idleReaders;
+    QList<QSharedPointer<ReaderQueue> > readerQueues;
+    QAtomicInt queuedReadRequests;
+    DbWorker * writer;
+    bool writerIdle;
+    QQueue<DbRequest> writeRequests;
+    mutable QMutex mutex;
+    QWaitCondition writeRequestArrived;
+    QString databaseName;
+    QSharedPointer<LeaderboardEngine> leaderboards;
+    QSharedPointer<TournamentSearchIndex> tournamentSearch;
+    QSharedPointer<AvatarStore> avatars;
+    QSharedPointer<ResponseCache> responses;
+    int numberOfReaders;
+    int queueCapacity;
+    bool running;
+
+    DbWorker * createWorker(bool writing);
+    bool takeReadRequest(DbWorker * worker, DbRequest & request);
+    void clearReaderQueues();
+
+public:
+    explicit DbWorkerPool(QSharedPointer<LeaderboardEngine> leaderboards,
+                          QSharedPointer<TournamentSearchIndex> tournamentSearch, QSharedPointer<AvatarStore> avatars,
+                          QSharedPointer<ResponseCache> responses, QObject * parent = nullptr);
+    ~DbWorkerPool();
+
+    void start();
+    void stop();
+
+    bool submit(const Packet & packet, QSharedPointer<ReplyChannel> channel);
+    bool takeRequest(DbWorker * worker, DbRequest & request);
+    bool takeGroupCommitRequest(DbRequest & request, qint64 timeout);
+
+    void connectionDrained(quint64 connectionId);
+    void connectionClosed(quint64 connectionId);
+
+    static bool isWriteRequest(int packetId);
+    static bool isGroupCommitRequest(int packetId);
+
+    int getQueueDepth() const;
+    void setDatabaseName(const QString & value);
+    void setNumberOfWorkers(int value);
+    void setQueueCapacity(int value);
+};
+
+#endif // DBWORKERPOOL_H
@@ -0,0 +1,88 @@
+#include "latencyhistogram.h"
+#include <QtAlgorithms>
+#include <QtMath>
+
+void LatencyHistogram::record(qint64 microseconds)
+{
+    if(microseconds < 0)
+        microseconds = 0;
+
+    buckets[bucketIndex(quint64(microseconds))].fetchAndAddRelaxed(1);
+    count.fetchAndAddRelaxed(1);
+    sum.fetchAndAddRelaxed(quint64(microseconds));
+}
+
+void LatencyHistogram::merge(const LatencyHistogram & other)
+{
+    for(int i=0; i<BUCKET_COUNT; i++)
+        buckets[i].fetchAndAddRelaxed(other.buckets[i].load());
+
+    count.fetchAndAddRelaxed(other.count.load());
+    sum.fetchAndAddRelaxed(other.sum.load());
+}
+
+// Every power of two is split into SUB_BUCKETS linear buckets, which keeps the relative error under 25%.
+int LatencyHistogram::bucketIndex(quint64 microseconds)
+{
+    if(microseconds < quint64(SUB_BUCKETS))
+        return int(microseconds);
+
+    int magnitude = 63 - int(qCountLeadingZeroBits(microseconds));
+    int subBucket = int(microseconds >> (magnitude - 2)) - SUB_BUCKETS;
+    int index = (magnitude - 1) * SUB_BUCKETS + subBucket;
+
+    return qMin(index, BUCKET_COUNT - 1);
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if(index < SUB_BUCKETS)
+        return index;
+
+    int magnitude = index / SUB_BUCKETS + 1;
+    int subBucket = index % SUB_BUCKETS;
+
+    return ((qint64(SUB_BUCKETS + subBucket + 1)) << (magnitude - 2)) - 1;
+}
+
+quint64 LatencyHistogram::getCount() const
+{
+    return count.load();
+}
+
+quint64 LatencyHistogram::getSum() const
+{
+    return sum.load();
+}
+
+quint64 LatencyHistogram::getBucketCount(int index) const
+{
+    if(index < 0 || index >= BUCKET_COUNT)
+        return 0;
+
+    return buckets[index].load();
+}
+
+qint64 LatencyHistogram::percentile(double fraction) const
+{
+    quint64 total = 0;
+
+    for(int i=0; i<BUCKET_COUNT; i++)
+        total += buckets[i].load();
+
+    if(total == 0)
+        return 0;
+
+    quint64 target = qMax<quint64>(1, quint64(qCeil(fraction * total)));
+    quint64 seen = 0;
+
+    for(int i=0; i<BUCKET_COUNT; i++)
+    {
+        seen += buckets[i].load();
+
+        if(seen >= target)
+            return bucketUpperBound(i);
+    }
+
+    return bucketUpperBound(BUCKET_COUNT - 1);
+}
@@ -0,0 +1,35 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QAtomicInteger>
+
+class LatencyHistogram
+{
+public:
+    static const int SUB_BUCKETS = 4;
+    static const int MAGNITUDES = 32;
+    static const int BUCKET_COUNT = SUB_BUCKETS * MAGNITUDES;
+
+private:
+    QAtomicInteger<quint64> buckets[BUCKET_COUNT];
+    QAtomicInteger<quint64> count;
+    QAtomicInteger<quint64> sum;
+
+    static int bucketIndex(quint64 microseconds);
+
+public:
+    LatencyHistogram() {}
+    ~LatencyHistogram() {}
+
+    void record(qint64 microseconds);
+    void merge(const LatencyHistogram & other);
+
+    quint64 getCount() const;
+    quint64 getSum() const;
+    quint64 getBucketCount(int index) const;
+    qint64 percentile(double fraction) const;
+
+    static qint64 bucketUpperBound(int index);
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,152 @@
+#include "leaderboardengine.h"
+#include <query.h>
+#include <algorithm>
+
+const QString LeaderboardEngine::LOADING_CONNECTION_NAME = QString("LeaderboardLoader");
+
+bool LeaderboardEngine::ranksHigher(const LeaderboardEntry & first, const LeaderboardEntry & second)
+{
+    if(first.points != second.points)
+        return first.points > second.points;
+
+    if(first.exactScore != second.exactScore)
+        return first.exactScore > second.exactScore;
+
+    if(first.predictedResult != second.predictedResult)
+        return first.predictedResult > second.predictedResult;
+
+    return first.nickname > second.nickname;
+}
+
+LeaderboardEngine::Leaderboard LeaderboardEngine::createLeaderboard(QVector<LeaderboardEntry> entries)
+{
+    Leaderboard leaderboard;
+    std::sort(entries.begin(), entries.end(), ranksHigher);
+    leaderboard.ranking = entries;
+
+    for(auto entry : entries)
+        leaderboard.participants.insert(entry.nickname, entry);
+
+    return leaderboard;
+}
+
+LeaderboardEntry LeaderboardEngine::createEntry(const QString & nickname, unsigned int exactScore,
+                                                unsigned int predictedResult)
+{
+    LeaderboardEntry entry;
+    entry.nickname = nickname;
+    entry.exactScore = exactScore;
+    entry.predictedResult = predictedResult;
+    entry.points = exactScore * 3 + predictedResult - exactScore;
+
+    return entry;
+}
+
+bool LeaderboardEngine::rebuild(const QString & databaseName)
+{
+    QSharedPointer<DbConnection> connection(new DbConnection);
+    QHash<unsigned int, QVector<LeaderboardEntry> > entries;
+
+    if(databaseName.isEmpty() ? !connection->connect(LOADING_CONNECTION_NAME) :
+                                !connection->connect(LOADING_CONNECTION_NAME, databaseName))
+        return false;
+
+    {
+        Query query(connection);
+        query.prepareLeaderboardSchema();
+        query.findAllLeaderboardsEntries();
+
+        while(query.next())
+        {
+            entries[query.value("tournament_id").toUInt()] << createEntry(query.value("nickname").toString(),
+                                                                           query.value("exact_score").toUInt(),
+                                                                           query.value("predicted_result").toUInt());
+        }
+    }
+
+    connection->close();
+
+    QWriteLocker locker(&lock);
+    leaderboards.clear();
+
+    for(auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+        leaderboards.insert(it.key(), createLeaderboard(it.value()));
+
+    return true;
+}
+
+unsigned int LeaderboardEngine::getVersion(unsigned int tournamentId) const
+{
+    QReadLocker locker(&lock);
+    return versions.value(tournamentId, 0);
+}
+
+bool LeaderboardEngine::setLeaderboard(unsigned int tournamentId, const QVector<LeaderboardEntry> & entries,
+                                       unsigned int version)
+{
+    Leaderboard leaderboard = createLeaderboard(entries);
+
+    QWriteLocker locker(&lock);
+
+    if(versions.value(tournamentId, 0) != version)
+        return false;
+
+    leaderboards.insert(tournamentId, leaderboard);
+    return true;
+}
+
+void LeaderboardEngine::invalidate(unsigned int tournamentId)
+{
+    QWriteLocker locker(&lock);
+    leaderboards.remove(tournamentId);
+    versions[tournamentId]++;
+}
+
+bool LeaderboardEngine::contains(unsigned int tournamentId) const
+{
+    QReadLocker locker(&lock);
+    return leaderboards.contains(tournamentId);
+}
+
+int LeaderboardEngine::numberOfParticipants(unsigned int tournamentId) const
+{
+    QReadLocker locker(&lock);
+    return leaderboards.value(tournamentId).ranking.size();
+}
+
+int LeaderboardEngine::findRank(unsigned int tournamentId, const QString & nickname, LeaderboardEntry & entry) const
+{
+    QReadLocker locker(&lock);
+    auto leaderboard = leaderboards.constFind(tournamentId);
+
+    if(leaderboard == leaderboards.constEnd() || !leaderboard->participants.contains(nickname))
+        return 0;
+
+    entry = leaderboard->participants.value(nickname);
+    auto position = std::lower_bound(leaderboard->ranking.constBegin(), leaderboard->ranking.constEnd(),
+                                     entry, ranksHigher);
+
+    return int(position - leaderboard->ranking.constBegin()) + 1;
+}
+
+QVector<LeaderboardEntry> LeaderboardEngine::findEntries(unsigned int tournamentId, int firstRank, int count) const
+{
+    QReadLocker locker(&lock);
+    auto leaderboard = leaderboards.constFind(tournamentId);
+
+    if(leaderboard == leaderboards.constEnd() || firstRank < 1 || count < 1)
+        return QVector<LeaderboardEntry>();
+
+    return leaderboard->ranking.mid(firstRank - 1, count);
+}
+
+QVector<LeaderboardEntry> LeaderboardEngine::findTop(unsigned int tournamentId, int count) const
+{
+    return findEntries(tournamentId, 1, count);
+}
+
+QVector<LeaderboardEntry> LeaderboardEngine::findWindow(unsigned int tournamentId, int rank, int radius) const
+{
+    int firstRank = qMax(1, rank - radius);
+    return findEntries(tournamentId, firstRank, rank + radius - firstRank + 1);
+}
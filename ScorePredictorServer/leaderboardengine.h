@@ -0,0 +1,56 @@
+#ifndef LEADERBOARDENGINE_H
+#define LEADERBOARDENGINE_H
+
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+#include <QSharedPointer>
+#include <dbconnection.h>
+
+struct LeaderboardEntry
+{
+    QString nickname;
+    unsigned int exactScore;
+    unsigned int predictedResult;
+    unsigned int points;
+};
+
+class LeaderboardEngine
+{
+private:
+    struct Leaderboard
+    {
+        QVector<LeaderboardEntry> ranking;
+        QHash<QString, LeaderboardEntry> participants;
+    };
+
+    QHash<unsigned int, Leaderboard> leaderboards;
+    QHash<unsigned int, unsigned int> versions;
+    mutable QReadWriteLock lock;
+
+    const static QString LOADING_CONNECTION_NAME;
+
+    static bool ranksHigher(const LeaderboardEntry & first, const LeaderboardEntry & second);
+    static Leaderboard createLeaderboard(QVector<LeaderboardEntry> entries);
+
+public:
+    LeaderboardEngine() {}
+    ~LeaderboardEngine() {}
+
+    bool rebuild(const QString & databaseName = QString());
+
+    unsigned int getVersion(unsigned int tournamentId) const;
+    bool setLeaderboard(unsigned int tournamentId, const QVector<LeaderboardEntry> & entries, unsigned int version);
+    void invalidate(unsigned int tournamentId);
+
+    bool contains(unsigned int tournamentId) const;
+    int numberOfParticipants(unsigned int tournamentId) const;
+    int findRank(unsigned int tournamentId, const QString & nickname, LeaderboardEntry & entry) const;
+    QVector<LeaderboardEntry> findEntries(unsigned int tournamentId, int firstRank, int count) const;
+    QVector<LeaderboardEntry> findTop(unsigned int tournamentId, int count) const;
+    QVector<LeaderboardEntry> findWindow(unsigned int tournamentId, int rank, int radius) const;
+
+    static LeaderboardEntry createEntry(const QString & nickname, unsigned int exactScore, unsigned int predictedResult);
+};
+
+#endif // LEADERBOARDENGINE_H
@@ -5,11 +5,13 @@ const QVariant Packet::END_OF_PACKET = QString("</EoP>");
 
 Packet::Packet()
 {
+    encoding = ENCODING_VARIANT;
     corrupted = true;
 }
 
-Packet::Packet(const QVariantList & packetData)
+Packet::Packet(const QVariantList & packetData, Encoding packetEncoding)
 {
+    encoding = packetEncoding;
     corrupted = false;
     data = packetData;
     serialize();
@@ -17,18 +19,45 @@ Packet::Packet(const QVariantList & packetData)
 
 Packet::Packet(QDataStream & in)
 {
+    encoding = ENCODING_VARIANT;
     corrupted = false;
     unserialize(in);
-    serialize();
+    validatePacket();
 }
 
 void Packet::serialize()
 {
     validatePacket();
 
+    if(corrupted)
+        return;
+
     QDataStream out(&serializedData, QIODevice::WriteOnly);
     out.setVersion(QDataStream::Qt_5_10);
-    out << quint16(0);
+    out << quint32(0);
+
+    if(encoding == ENCODING_COMPACT)
+        serializeCompact(out);
+    else
+        serializeVariant(out);
+
+    if(corrupted)
+        return;
+
+    if(quint64(serializedData.size() - sizeof(quint32)) > MAX_PACKET_SIZE)
+    {
+        error = "Packet is too large.";
+        corrupted = true;
+        clean();
+        return;
+    }
+
+    out.device()->seek(0);
+    out << quint32(serializedData.size() - sizeof(quint32));
+}
+
+void Packet::serializeVariant(QDataStream & out)
+{
     out << START_OF_PACKET;
 
     for(auto dataElement : data)
@@ -45,11 +74,34 @@ void Packet::serialize()
     }
 
     out << END_OF_PACKET;
-    out.device()->seek(0);
-    out << quint16(serializedData.size() - sizeof(quint16));
+}
+
+void Packet::serializeCompact(QDataStream & out)
+{
+    out << COMPACT_MAGIC;
+    writeVarint(out, quint64(data.count()));
+
+    for(auto dataElement : data)
+        writeCompact(out, dataElement);
 }
 
 void Packet::unserialize(QDataStream & in)
+{
+    char marker = 0;
+
+    if(in.device() && in.device()->peek(&marker, 1) == 1 && quint8(marker) == COMPACT_MAGIC)
+    {
+        encoding = ENCODING_COMPACT;
+        unserializeCompact(in);
+    }
+    else
+    {
+        encoding = ENCODING_VARIANT;
+        unserializeVariant(in);
+    }
+}
+
+void Packet::unserializeVariant(QDataStream & in)
 {
     QVariant sop;
     in >> sop;
@@ -86,6 +138,362 @@ void Packet::unserialize(QDataStream & in)
     }
 }
 
+void Packet::unserializeCompact(QDataStream & in)
+{
+    quint8 magic;
+    quint64 count;
+    in >> magic;
+
+    if(!readVarint(in, count))
+    {
+        error = "Compact packet header is truncated.";
+        corrupted = true;
+        clean();
+        return;
+    }
+
+    for(quint64 i=0; i<count; i++)
+    {
+        QVariant var;
+
+        if(!readCompact(in, var))
+        {
+            error = "Compact packet body is malformed.";
+            corrupted = true;
+            clean();
+            return;
+        }
+        data << var;
+    }
+}
+
+void Packet::writeCompact(QDataStream & out, const QVariant & value)
+{
+    switch(value.userType())
+    {
+    case QMetaType::UnknownType:
+        out << quint8(TAG_INVALID);
+        return;
+
+    case QMetaType::Bool:
+        out << quint8(value.toBool() ? TAG_TRUE : TAG_FALSE);
+        return;
+
+    case QMetaType::Int:
+    case QMetaType::LongLong:
+    {
+        qint64 number = value.toLongLong();
+        out << quint8(value.userType() == QMetaType::Int ? TAG_INT : TAG_LONGLONG);
+        writeVarint(out, (quint64(number) << 1) ^ quint64(number >> 63));
+        return;
+    }
+
+    case QMetaType::UInt:
+    case QMetaType::ULongLong:
+        out << quint8(value.userType() == QMetaType::UInt ? TAG_UINT : TAG_ULONGLONG);
+        writeVarint(out, value.toULongLong());
+        return;
+
+    case QMetaType::Double:
+        out << quint8(TAG_DOUBLE) << value.toDouble();
+        return;
+
+    case QMetaType::QString:
+        out << quint8(TAG_STRING);
+        writeBytes(out, value.toString().toUtf8());
+        return;
+
+    case QMetaType::QByteArray:
+        out << quint8(TAG_BYTEARRAY);
+        writeBytes(out, value.toByteArray());
+        return;
+
+    case QMetaType::QDate:
+        if(!value.toDate().isValid())
+            break;
+
+        out << quint8(TAG_DATE);
+        writeVarint(out, quint64(value.toDate().toJulianDay()));
+        return;
+
+    case QMetaType::QTime:
+        if(!value.toTime().isValid())
+            break;
+
+        out << quint8(TAG_TIME);
+        writeVarint(out, quint64(value.toTime().msecsSinceStartOfDay()));
+        return;
+
+    case QMetaType::QDateTime:
+    {
+        QDateTime dateTime = value.toDateTime();
+
+        if(!dateTime.isValid() || dateTime.timeSpec() == Qt::TimeZone)
+            break;
+
+        qint64 msecs = dateTime.toMSecsSinceEpoch();
+        qint64 offset = dateTime.offsetFromUtc();
+        out << quint8(TAG_DATETIME);
+        writeVarint(out, (quint64(msecs) << 1) ^ quint64(msecs >> 63));
+        out << quint8(dateTime.timeSpec());
+
+        if(dateTime.timeSpec() == Qt::OffsetFromUTC)
+            writeVarint(out, (quint64(offset) << 1) ^ quint64(offset >> 63));
+        return;
+    }
+
+    case QMetaType::QVariantList:
+    {
+        QVariantList list = value.toList();
+        out << quint8(TAG_LIST);
+        writeVarint(out, quint64(list.count()));
+
+        for(auto element : list)
+            writeCompact(out, element);
+        return;
+    }
+
+    case QMetaType::QVariantMap:
+    {
+        QVariantMap map = value.toMap();
+        out << quint8(TAG_MAP);
+        writeVarint(out, quint64(map.count()));
+
+        for(auto it = map.constBegin(); it != map.constEnd(); ++it)
+        {
+            writeBytes(out, it.key().toUtf8());
+            writeCompact(out, it.value());
+        }
+        return;
+    }
+
+    default:
+        break;
+    }
+
+    // Types without a compact form, as well as null dates and named time zones, keep the QDataStream layout.
+    QByteArray variantData;
+    QDataStream variantStream(&variantData, QIODevice::WriteOnly);
+    variantStream.setVersion(QDataStream::Qt_5_10);
+    variantStream << value;
+
+    out << quint8(TAG_VARIANT);
+    writeBytes(out, variantData);
+}
+
+void Packet::writeVarint(QDataStream & out, quint64 value)
+{
+    while(value >= 0x80)
+    {
+        out << quint8((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+
+    out << quint8(value);
+}
+
+void Packet::writeBytes(QDataStream & out, const QByteArray & bytes)
+{
+    writeVarint(out, quint64(bytes.size()));
+    out.writeRawData(bytes.constData(), bytes.size());
+}
+
+bool Packet::readCompact(QDataStream & in, QVariant & value, int depth)
+{
+    quint8 tag;
+    quint64 number;
+    QByteArray bytes;
+    in >> tag;
+
+    if(in.status() != QDataStream::Ok || depth > COMPACT_MAX_DEPTH)
+        return false;
+
+    switch(tag)
+    {
+    case TAG_INVALID:
+        value = QVariant();
+        return true;
+
+    case TAG_FALSE:
+    case TAG_TRUE:
+        value = QVariant(tag == TAG_TRUE);
+        return true;
+
+    case TAG_INT:
+    case TAG_LONGLONG:
+    {
+        if(!readVarint(in, number))
+            return false;
+
+        qint64 signedNumber = qint64(number >> 1) ^ -qint64(number & 1);
+
+        if(tag == TAG_INT)
+            value = QVariant(int(signedNumber));
+        else
+            value = QVariant(signedNumber);
+        return true;
+    }
+
+    case TAG_UINT:
+    case TAG_ULONGLONG:
+        if(!readVarint(in, number))
+            return false;
+
+        if(tag == TAG_UINT)
+            value = QVariant(uint(number));
+        else
+            value = QVariant(number);
+        return true;
+
+    case TAG_DOUBLE:
+    {
+        double floatingNumber;
+        in >> floatingNumber;
+        value = QVariant(floatingNumber);
+        return in.status() == QDataStream::Ok;
+    }
+
+    case TAG_STRING:
+        if(!readBytes(in, bytes))
+            return false;
+
+        value = QVariant(QString::fromUtf8(bytes));
+        return true;
+
+    case TAG_BYTEARRAY:
+        if(!readBytes(in, bytes))
+            return false;
+
+        value = QVariant(bytes);
+        return true;
+
+    case TAG_DATE:
+        if(!readVarint(in, number))
+            return false;
+
+        value = QVariant(QDate::fromJulianDay(qint64(number)));
+        return true;
+
+    case TAG_TIME:
+        if(!readVarint(in, number))
+            return false;
+
+        value = QVariant(QTime::fromMSecsSinceStartOfDay(int(number)));
+        return true;
+
+    case TAG_DATETIME:
+    {
+        quint8 timeSpec;
+        quint64 offset = 0;
+
+        if(!readVarint(in, number))
+            return false;
+
+        in >> timeSpec;
+
+        if(in.status() != QDataStream::Ok)
+            return false;
+
+        if(timeSpec == Qt::OffsetFromUTC && !readVarint(in, offset))
+            return false;
+
+        qint64 msecs = qint64(number >> 1) ^ -qint64(number & 1);
+        int offsetSeconds = int(qint64(offset >> 1) ^ -qint64(offset & 1));
+        value = QVariant(QDateTime::fromMSecsSinceEpoch(msecs, Qt::TimeSpec(timeSpec), offsetSeconds));
+        return true;
+    }
+
+    case TAG_LIST:
+    {
+        QVariantList list;
+
+        if(!readVarint(in, number))
+            return false;
+
+        for(quint64 i=0; i<number; i++)
+        {
+            QVariant element;
+
+            if(!readCompact(in, element, depth + 1))
+                return false;
+
+            list << element;
+        }
+
+        value = QVariant::fromValue(list);
+        return true;
+    }
+
+    case TAG_MAP:
+    {
+        QVariantMap map;
+
+        if(!readVarint(in, number))
+            return false;
+
+        for(quint64 i=0; i<number; i++)
+        {
+            QVariant element;
+
+            if(!readBytes(in, bytes) || !readCompact(in, element, depth + 1))
+                return false;
+
+            map.insert(QString::fromUtf8(bytes), element);
+        }
+
+        value = QVariant::fromValue(map);
+        return true;
+    }
+
+    case TAG_VARIANT:
+    {
+        if(!readBytes(in, bytes))
+            return false;
+
+        QDataStream variantStream(bytes);
+        variantStream.setVersion(QDataStream::Qt_5_10);
+        variantStream >> value;
+        return variantStream.status() == QDataStream::Ok;
+    }
+
+    default:
+        return false;
+    }
+}
+
+bool Packet::readVarint(QDataStream & in, quint64 & value)
+{
+    value = 0;
+
+    for(int shift = 0; shift < 64; shift += 7)
+    {
+        quint8 byte;
+        in >> byte;
+
+        if(in.status() != QDataStream::Ok)
+            return false;
+
+        value |= quint64(byte & 0x7F) << shift;
+
+        if(!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+bool Packet::readBytes(QDataStream & in, QByteArray & bytes)
+{
+    quint64 size;
+
+    if(!readVarint(in, size) || !in.device() || size > quint64(in.device()->bytesAvailable()))
+        return false;
+
+    bytes.resize(int(size));
+
+    return in.readRawData(bytes.data(), int(size)) == int(size);
+}
+
 void Packet::validatePacket()
 {
     if(corrupted)
@@ -106,10 +514,11 @@ void Packet::validatePacket()
     }
 }
 
-void Packet::setSerializedData(const QVariantList & packetData)
+void Packet::setSerializedData(const QVariantList & packetData, Encoding packetEncoding)
 {
     clean();
     error.clear();
+    encoding = packetEncoding;
     corrupted = false;
     data = packetData;
     serialize();
@@ -121,7 +530,14 @@ void Packet::setUnserializedData(QDataStream & in)
     error.clear();
     corrupted = false;
     unserialize(in);
-    serialize();
+    validatePacket();
+}
+
+void Packet::setUnserializedData(const QByteArray & packetBody)
+{
+    QDataStream in(packetBody);
+    in.setVersion(QDataStream::Qt_5_10);
+    setUnserializedData(in);
 }
 
 void Packet::clean()
@@ -140,6 +556,11 @@ QByteArray Packet::getSerializedData() const
     return serializedData;
 }
 
+Packet::Encoding Packet::getEncoding() const
+{
+    return encoding;
+}
+
 bool Packet::isCorrupted() const
 {
     return corrupted;
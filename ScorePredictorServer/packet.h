@@ -4,40 +4,86 @@
 #include <QByteArray>
 #include <QVariantList>
 #include <QDataStream>
+#include <QDateTime>
 
 class Packet
 {
+public:
+    enum Encoding
+    {
+        ENCODING_VARIANT = 0,
+        ENCODING_COMPACT = 1
+    };
+
 private:
+    enum CompactTag
+    {
+        TAG_INVALID = 0,
+        TAG_FALSE,
+        TAG_TRUE,
+        TAG_INT,
+        TAG_UINT,
+        TAG_LONGLONG,
+        TAG_ULONGLONG,
+        TAG_DOUBLE,
+        TAG_STRING,
+        TAG_BYTEARRAY,
+        TAG_DATETIME,
+        TAG_DATE,
+        TAG_TIME,
+        TAG_LIST,
+        TAG_MAP,
+        TAG_VARIANT
+    };
+
     QVariantList data;
     QByteArray serializedData;
+    Encoding encoding;
     bool corrupted;
     QString error;
 
     static const QVariant START_OF_PACKET;
     static const QVariant END_OF_PACKET;
+    static const quint8 COMPACT_MAGIC = 0xC5;
+    static const int COMPACT_MAX_DEPTH = 16;
     static const int PACKET_ID_MIN = 0;
-    static const int PACKET_ID_MAX = 35;
+    static const int PACKET_ID_MAX = 42;
 
     void serialize();
+    void serializeVariant(QDataStream & out);
+    void serializeCompact(QDataStream & out);
     void unserialize(QDataStream & in);
+    void unserializeVariant(QDataStream & in);
+    void unserializeCompact(QDataStream & in);
     void clean();
     void validatePacket();
 
+    static void writeCompact(QDataStream & out, const QVariant & value);
+    static void writeVarint(QDataStream & out, quint64 value);
+    static void writeBytes(QDataStream & out, const QByteArray & bytes);
+    static bool readCompact(QDataStream & in, QVariant & value, int depth = 0);
+    static bool readVarint(QDataStream & in, quint64 & value);
+    static bool readBytes(QDataStream & in, QByteArray & bytes);
+
 public:
     Packet();
-    Packet(const QVariantList & packetData);
+    Packet(const QVariantList & packetData, Encoding packetEncoding = ENCODING_VARIANT);
     Packet(QDataStream & in);
     ~Packet() {}
 
-    void setSerializedData(const QVariantList & packetData);
+    void setSerializedData(const QVariantList & packetData, Encoding packetEncoding = ENCODING_VARIANT);
     void setUnserializedData(QDataStream & in);
+    void setUnserializedData(const QByteArray & packetBody);
 
     QVariantList getUnserializedData() const;
     QByteArray getSerializedData() const;
+    Encoding getEncoding() const;
 
     bool isCorrupted() const;
     QString lastError() const;
 
+    static const quint32 MAX_PACKET_SIZE = 16 * 1024 * 1024;
+
     static const int ID_ERROR = 0;
     static const int ID_DOWNLOAD_STARTING_MESSAGE = 1;
     static const int ID_REGISTER = 2;
@@ -74,6 +120,13 @@ public:
     static const int ID_MAKE_PREDICTION_ERROR = 33;
     static const int ID_UPDATE_PREDICTION = 34;
     static const int ID_UPDATE_PREDICTION_ERROR = 35;
+    static const int ID_PULL_MATCHES_BY_ID = 36;
+    static const int ID_UPDATE_MATCH_SCORE_BY_ID = 37;
+    static const int ID_MAKE_PREDICTION_BY_ID = 38;
+    static const int ID_UPDATE_PREDICTION_BY_ID = 39;
+    static const int ID_DOWNLOAD_LEADERBOARD_RANK = 40;
+    static const int ID_DOWNLOAD_LEADERBOARD_PAGE = 41;
+    static const int ID_NEGOTIATE_ENCODING = 42;
 };
 
 #endif // PACKET_H
@@ -0,0 +1,97 @@
+#include "packetbuffer.h"
+#include <QtEndian>
+#include <cstring>
+
+PacketBuffer::PacketBuffer()
+{
+    readPosition = 0;
+    writePosition = 0;
+    lastFrameSize = 0;
+    overflowed = false;
+}
+
+qint64 PacketBuffer::readFrom(QIODevice * device)
+{
+    qint64 available = device->bytesAvailable();
+
+    if(available <= 0 || overflowed)
+        return 0;
+
+    if(available > qint64(Packet::MAX_PACKET_SIZE))
+        available = Packet::MAX_PACKET_SIZE;
+
+    reserve(int(available));
+    qint64 bytesRead = device->read(buffer.data() + writePosition, available);
+
+    if(bytesRead > 0)
+        writePosition += int(bytesRead);
+
+    return bytesRead;
+}
+
+bool PacketBuffer::takePacket(Packet & packet)
+{
+    int available = writePosition - readPosition;
+
+    if(overflowed || available < int(sizeof(quint32)))
+        return false;
+
+    quint32 packetSize = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(buffer.constData() + readPosition));
+
+    if(packetSize > Packet::MAX_PACKET_SIZE)
+    {
+        overflowed = true;
+        return false;
+    }
+
+    if(quint32(available) - sizeof(quint32) < packetSize)
+        return false;
+
+    // The packet decodes straight out of the buffer; nothing is copied before decoding.
+    packet.setUnserializedData(QByteArray::fromRawData(buffer.constData() + readPosition + sizeof(quint32),
+                                                       int(packetSize)));
+    lastFrameSize = int(sizeof(quint32) + packetSize);
+    readPosition += lastFrameSize;
+
+    if(readPosition == writePosition)
+    {
+        readPosition = 0;
+        writePosition = 0;
+
+        if(buffer.size() > RETAINED_CAPACITY)
+            buffer = QByteArray();
+    }
+
+    return true;
+}
+
+void PacketBuffer::reserve(int size)
+{
+    if(readPosition > 0 && buffer.size() - writePosition < size)
+    {
+        std::memmove(buffer.data(), buffer.constData() + readPosition, size_t(writePosition - readPosition));
+        writePosition -= readPosition;
+        readPosition = 0;
+    }
+
+    if(buffer.size() - writePosition < size)
+        buffer.resize(qMax(qMax(INITIAL_CAPACITY, buffer.size() * 2), writePosition + size));
+}
+
+int PacketBuffer::getLastFrameSize() const
+{
+    return lastFrameSize;
+}
+
+bool PacketBuffer::hasOverflowed() const
+{
+    return overflowed;
+}
+
+void PacketBuffer::clear()
+{
+    buffer = QByteArray();
+    readPosition = 0;
+    writePosition = 0;
+    overflowed = false;
+}
@@ -0,0 +1,34 @@
+#ifndef PACKETBUFFER_H
+#define PACKETBUFFER_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include "packet.h"
+
+class PacketBuffer
+{
+private:
+    QByteArray buffer;
+    int readPosition;
+    int writePosition;
+    int lastFrameSize;
+    bool overflowed;
+
+    static const int INITIAL_CAPACITY = 16 * 1024;
+    static const int RETAINED_CAPACITY = 1024 * 1024;
+
+    void reserve(int size);
+
+public:
+    PacketBuffer();
+    ~PacketBuffer() {}
+
+    qint64 readFrom(QIODevice * device);
+    bool takePacket(Packet & packet);
+
+    int getLastFrameSize() const;
+    bool hasOverflowed() const;
+    void clear();
+};
+
+#endif // PACKETBUFFER_H
@@ -2,26 +2,163 @@
 
 namespace Server
 {
-    const QString PacketProcessor::STARTING_MESSAGE_PATH = QString("data/starting_message.txt");
     const QString PacketProcessor::DEFAULT_AVATAR_PATH = QString("avatars/default_avatar.png");
-
-    PacketProcessor::PacketProcessor(QSharedPointer<DbConnection> connection, QObject * parent) : QObject(parent)
+    const int PacketProcessor::LEADERBOARD_PAGE_LIMIT = 200;
+    const int PacketProcessor::MATCHES_CHUNK_SIZE = 250;
+    const int PacketProcessor::PARTICIPANTS_CHUNK_SIZE = 500;
+
+    PacketProcessor::PacketProcessor(QSharedPointer<DbConnection> connection,
+                                     QSharedPointer<LeaderboardEngine> leaderboardEngine,
+                                     QSharedPointer<TournamentSearchIndex> searchIndex,
+                                     QSharedPointer<AvatarStore> avatarStore,
+                                     QSharedPointer<ResponseCache> responseCache, QObject * parent)
+        : QObject(parent)
     {
         dbConnection = connection;
+        leaderboards = leaderboardEngine;
+        tournamentSearch = searchIndex;
+        avatars = avatarStore;
+        responses = responseCache;
+        replyBuffering = false;
+        replyRecording = false;
+        recordedBytes = 0;
+        currentPacketId = -1;
     }
 
-    void PacketProcessor::processPacket(const Packet & packet)
+    void PacketProcessor::processRequest(const Packet & packet, QSharedPointer<ReplyChannel> channel)
     {
-        if(!dbConnection->isConnected())
+        if(!channel)
             return;
 
+        replyChannel = channel;
+        currentPacketId = packet.getUnserializedData()[0].toInt();
+        qint64 startTime = ServerMetrics::now();
+
+        if(dbConnection->isConnected())
+            dispatchPacket(packet);
+        else
+        {
+            QVariantList responseData;
+            responseData << Packet::ID_ERROR << QString("The database is unavailable. Try again later.");
+            reply(responseData);
+        }
+
+        if(!pausedStreams.contains(channel->getConnectionId()))
+        {
+            if(replyBuffering)
+                finishedChannels << channel;
+            else
+                channel->finish();
+        }
+
+        ServerMetrics::recordStage(currentPacketId, ServerMetrics::STAGE_DATABASE, startTime);
+        currentPacketId = -1;
+        replyChannel.reset();
+    }
+
+    void PacketProcessor::setReplyBuffering(bool enabled)
+    {
+        replyBuffering = enabled;
+    }
+
+    void PacketProcessor::flushBufferedReplies()
+    {
+        for(auto bufferedReply : bufferedReplies)
+            bufferedReply.first->send(bufferedReply.second);
+
+        for(auto channel : finishedChannels)
+            channel->finish();
+
+        discardBufferedReplies();
+    }
+
+    void PacketProcessor::discardBufferedReplies()
+    {
+        bufferedReplies.clear();
+        finishedChannels.clear();
+        replyBuffering = false;
+    }
+
+    void PacketProcessor::reply(const QVariantList & data)
+    {
+        if(!replyChannel)
+            return;
+
+        if(ServerMetrics::isErrorReply(data[0].toInt()))
+            ServerMetrics::recordError(currentPacketId);
+
+        if(replyBuffering)
+            bufferedReplies << qMakePair(replyChannel, data);
+        else if(replyRecording)
+            recordReply(data);
+        else
+            replyChannel->send(data);
+    }
+
+    void PacketProcessor::recordReply(const QVariantList & data)
+    {
+        QByteArray frame = replyChannel->encode(data);
+
+        if(frame.isEmpty())
+            return;
+
+        replyChannel->sendFrame(data[0].toInt(), frame);
+
+        ResponseFrame responseFrame;
+        responseFrame.packetId = data[0].toInt();
+        responseFrame.data = frame;
+
+        recordedReplies << responseFrame;
+        recordedBytes += frame.size();
+
+        // Large replies are not worth the memory, the rest of this one is sent as usual.
+        if(recordedBytes > ResponseCache::MAX_RESPONSE_SIZE)
+        {
+            replyRecording = false;
+            recordedReplies.clear();
+            recordedBytes = 0;
+        }
+    }
+
+    bool PacketProcessor::replyFromCache(int packetId, unsigned int entityId, unsigned int version)
+    {
+        QList<ResponseFrame> frames;
+
+        if(!responses->find(packetId, entityId, version, replyChannel->getEncoding(), frames))
+            return false;
+
+        for(const ResponseFrame & frame : frames)
+            replyChannel->sendFrame(frame.packetId, frame.data);
+
+        return true;
+    }
+
+    void PacketProcessor::startRecordingReplies()
+    {
+        replyRecording = !replyBuffering;
+        recordedReplies.clear();
+        recordedBytes = 0;
+    }
+
+    void PacketProcessor::finishRecordingReplies(int packetId, unsigned int entityId, unsigned int version)
+    {
+        // A stream paused by backpressure sends its remaining chunks later, so the recording is incomplete.
+        if(replyRecording && !recordedReplies.isEmpty() && !pausedStreams.contains(replyChannel->getConnectionId()))
+            responses->insert(packetId, entityId, version, replyChannel->getEncoding(), recordedReplies);
+
+        replyRecording = false;
+        recordedReplies.clear();
+        recordedBytes = 0;
+    }
+
+    void PacketProcessor::dispatchPacket(const Packet & packet)
+    {
         QVariantList data = packet.getUnserializedData();
         int packetId = data[0].toInt();
         data.removeFirst();
 
         switch(packetId)
         {
-        case Packet::ID_DOWNLOAD_STARTING_MESSAGE: manageDownloadingStartingMessage(); break;
         case Packet::ID_REGISTER: registerUser(data); break;
         case Packet::ID_LOGIN: loginUser(data); break;
         case Packet::ID_DOWNLOAD_USER_PROFILE_INFO: manageDownloadingUserInfo(data); break;
@@ -45,35 +182,20 @@ namespace Server
         case Packet::ID_PULL_MATCHES_PREDICTIONS: managePullingMatchesPredictions(data); break;
         case Packet::ID_MAKE_PREDICTION: manageMakingPrediction(data); break;
         case Packet::ID_UPDATE_PREDICTION: manageUpdatingPrediction(data); break;
+        case Packet::ID_PULL_MATCHES_BY_ID: managePullingMatchesById(data); break;
+        case Packet::ID_UPDATE_MATCH_SCORE_BY_ID: manageUpdatingMatchScoreById(data); break;
+        case Packet::ID_MAKE_PREDICTION_BY_ID: manageMakingPredictionById(data); break;
+        case Packet::ID_UPDATE_PREDICTION_BY_ID: manageUpdatingPredictionById(data); break;
+        case Packet::ID_DOWNLOAD_LEADERBOARD_RANK: manageDownloadingLeaderboardRank(data); break;
+        case Packet::ID_DOWNLOAD_LEADERBOARD_PAGE: manageDownloadingLeaderboardPage(data); break;
 
         default: break;
         }
     }
 
-    void PacketProcessor::manageDownloadingStartingMessage()
-    {
-        QVariantList responseData;
-        QFile file(STARTING_MESSAGE_PATH);
-
-        if(!file.open(QIODevice::ReadOnly))
-            responseData << Packet::ID_ERROR << QString("Couldn't load starting message.");
-        else
-        {
-            QTextStream fileStream(&file);
-            fileStream.setCodec("UTF-8");
-
-            QString startingMessage = fileStream.readAll();
-
-            file.close();
-            responseData << Packet::ID_DOWNLOAD_STARTING_MESSAGE << startingMessage;
-        }
-
-        emit response(responseData);
-    }
-
     void PacketProcessor::registerUser(const QVariantList & userData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
         responseData << Packet::ID_REGISTER;
 
@@ -87,12 +209,12 @@ namespace Server
                 responseData << false << QString("A problem occured. Account could not be created");
         }
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::loginUser(const QVariantList & userData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
         responseData << Packet::ID_LOGIN;
 
@@ -108,42 +230,40 @@ namespace Server
         else
             responseData << false << false << QString("Invalid nickname");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageDownloadingUserInfo(const QVariantList & userData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.getUserInfo(userData[0].toString()))
         {
-            QString avatarPath = query.value("avatar_path").toString();
-            QImage avatar;
-            QByteArray avatarData;
-            QBuffer avatarBuffer(&avatarData);
-            QFileInfo avatarInfo(avatarPath);
+            Avatar avatar;
 
-            if(!avatarInfo.exists())
+            if(!avatars->load(query.value("avatar_path").toString(), avatar, userData.value(2).toInt()))
                 responseData << Packet::ID_ERROR << QString("Couldn't load user data");
             else
             {
-                avatar.load(avatarPath);
-                avatar.save(&avatarBuffer, avatarInfo.suffix().toLocal8Bit().constData());
+                // A client that already holds this avatar gets only its hash back. The nickname is echoed so that
+                // a client with several profile requests in flight knows whose avatar this is.
+                QByteArray knownHash = userData.value(1).toByteArray();
 
                 responseData << Packet::ID_DOWNLOAD_USER_PROFILE_INFO << query.value("description")
-                             << avatarData;
+                             << (knownHash == avatar.hash ? QByteArray() : avatar.data) << avatar.hash
+                             << userData[0].toString();
             }
         }
         else
             responseData << Packet::ID_ERROR << QString("Couldn't load user data");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::managePullingUserTournaments(const QVariantList & userData, bool opened)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(userData[0].toString()))
@@ -165,12 +285,12 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("User does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageUpdatingUserProfileDescription(const QVariantList & requestData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(requestData[0].toString()))
@@ -191,12 +311,12 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("User does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageUpdatingUserProfileAvatar(const QVariantList & requestData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(requestData[0].toString()))
@@ -205,33 +325,21 @@ namespace Server
 
             query.findUserProfileAvatarPath(userId);
             QString oldAvatarPath = query.value("avatar_path").toString();
-            QString newAvatarPath = DEFAULT_AVATAR_PATH.left(DEFAULT_AVATAR_PATH.lastIndexOf('/')) + "/" +
-                                    requestData[0].toString() + "." + requestData[2].toString();
+            QString newAvatarPath;
 
-            QImage avatar;
-            avatar.loadFromData(requestData[1].toByteArray());
-
-            if(!avatar.isNull())
+            if(avatars->store(requestData[1].toByteArray(), newAvatarPath))
             {
-                if(oldAvatarPath != DEFAULT_AVATAR_PATH)
-                {
-                    QFile oldAvatar(oldAvatarPath);
-                    oldAvatar.remove();
-                }
-
-                if(avatar.save(newAvatarPath))
+                if(oldAvatarPath != newAvatarPath)
                 {
-                    if(oldAvatarPath != newAvatarPath)
-                        query.updateUserProfileAvatarPath(userId, newAvatarPath);
+                    query.updateUserProfileAvatarPath(userId, newAvatarPath);
 
-                    responseData << Packet::ID_UPDATE_USER_PROFILE_AVATAR
-                                 << QString("Avatar successfully updated.");
-                }
-                else
-                {
-                    responseData << Packet::ID_UPDATE_USER_PROFILE_AVATAR_ERROR
-                                 << QString("Avatar couldn't be updated. Try again later.");
+                    // Avatars are shared by content, the old file goes only when nobody points at it any more.
+                    if(oldAvatarPath != DEFAULT_AVATAR_PATH && !query.isAvatarPathInUse(oldAvatarPath))
+                        avatars->remove(oldAvatarPath);
                 }
+
+                responseData << Packet::ID_UPDATE_USER_PROFILE_AVATAR
+                             << QString("Avatar successfully updated.");
             }
             else
             {
@@ -242,13 +350,13 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("User does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageTournamentCreationRequest(QVariantList & tournamentData)
     {
         Tournament tournament(tournamentData[0].value<QVariantList>());
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(tournament.getHostName()))
@@ -264,6 +372,10 @@ namespace Server
                 }
                 else if(query.createTournament(tournament, hostId, tournamentData[1].toString()))
                 {
+                    tournamentSearch->addTournament(TournamentSearchIndex::createEntry(
+                        query.lastInsertId().toUInt(), tournament.getName(), tournament.getHostName(),
+                        !tournamentData[1].toString().isEmpty(), tournament.getEntriesEndTime(),
+                        tournament.getPredictorsLimit()));
                     responseData << Packet::ID_CREATE_TOURNAMENT << true
                                  << QString("Tournament created successfully");
                 }
@@ -282,12 +394,12 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("User does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::managePullingTournaments(const QVariantList & requestData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(requestData[0].toString()))
@@ -300,6 +412,21 @@ namespace Server
             else
                 startFromTime = QDateTime::currentDateTime();
 
+            if(tournamentSearch->isReady())
+            {
+                for(auto entry : tournamentSearch->find(query.value("id").toUInt(), startFromTime,
+                                                        requestData[1].toInt(), requestData[2].toString()))
+                {
+                    QVariantList tournamentData;
+                    tournamentData << entry.name << entry.hostName << int(entry.passwordRequired)
+                                   << entry.entriesEndTime << entry.predictors << entry.predictorsLimit;
+                    responseData << QVariant::fromValue(tournamentData);
+                }
+
+                reply(responseData);
+                return;
+            }
+
             query.findTournaments(query.value("id").toUInt(), startFromTime, requestData[1].toInt(),
                                   requestData[2].toString());
 
@@ -315,12 +442,12 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("User does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageJoiningTournament(const QVariantList & requestData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(requestData[0].toString()))
@@ -341,7 +468,12 @@ namespace Server
                                     QString("This tournament requires password");
 
                 else if(query.addUserToTournament(tournamentId, userId))
+                {
+                    leaderboards->invalidate(tournamentId);
+                    responses->invalidate(Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD, tournamentId);
+                    tournamentSearch->addParticipant(tournamentId, userId);
                     responseData << Packet::ID_JOIN_TOURNAMENT << true << QString("You joined the tournament");
+                }
 
                 else
                     responseData << Packet::ID_ERROR << false << QString("A problem occured. Try again later.");
@@ -352,12 +484,12 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("User does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageJoiningTournamentWithPassword(const QVariantList & requestData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(requestData[0].toString()))
@@ -377,7 +509,12 @@ namespace Server
                     responseData << Packet::ID_JOIN_TOURNAMENT << false << QString("Incorrect password");
 
                 else if(query.addUserToTournament(tournamentId, userId))
+                {
+                    leaderboards->invalidate(tournamentId);
+                    responses->invalidate(Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD, tournamentId);
+                    tournamentSearch->addParticipant(tournamentId, userId);
                     responseData << Packet::ID_JOIN_TOURNAMENT << true << QString("You joined the tournament");
+                }
 
                 else
                     responseData << Packet::ID_ERROR << false << QString("A problem occured. Try again later.");
@@ -388,12 +525,12 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("User does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     QString PacketProcessor::validateTournamentJoining(unsigned int tournamentId, unsigned int userId)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
 
         if(!query.tournamentIsOpened(tournamentId))
             return QString("This tournament is closed");
@@ -412,7 +549,7 @@ namespace Server
 
     void PacketProcessor::manageDownloadingTournamentInfo(const QVariantList & tournamentData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(tournamentData[1].toString()) &&
@@ -432,21 +569,25 @@ namespace Server
 
             query.findTournamentRounds(tournamentId);
             QVariantList roundsData;
+            QVariantList roundsIds;
 
             while(query.next())
+            {
                 roundsData << query.value("name");
+                roundsIds << query.value("id").toUInt();
+            }
 
-            responseData << QVariant::fromValue(roundsData);
+            responseData << QVariant::fromValue(roundsData) << tournamentId << QVariant::fromValue(roundsIds);
         }
         else
             responseData << Packet::ID_ERROR << QString("This tournament does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageTournamentFinishing(const QVariantList & tournamentData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(tournamentData[1].toString()) &&
@@ -465,7 +606,10 @@ namespace Server
                                                      "unfinished matches.");
 
                 else if(query.finishTournament(tournamentId))
+                {
+                    responses->invalidate(Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD, tournamentId);
                     responseData << true << QString("Tournament finished");
+                }
                 else
                     responseData << false << QString("Finishing this tournament is not possible now. Try again later.");
             }
@@ -475,12 +619,12 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("This tournament does not exist");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageAddingNewRound(const QVariantList & tournamentData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(tournamentData[1].toString()) &&
@@ -495,7 +639,7 @@ namespace Server
                     responseData << false << QString("A round with the same name already exists.");
 
                 else if(query.addNewRound(tournamentData[2].toString(), tournamentId))
-                    responseData << true << tournamentData[2].toString();
+                    responseData << true << tournamentData[2].toString() << query.lastInsertId().toUInt();
                 else
                     responseData << false << QString("Adding new round is not possible right now. Try again later.");
             }
@@ -505,175 +649,414 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("This tournament does not exist.");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageDownloadingTournamentLeaderboard(const QVariantList & tournamentData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(tournamentData[1].toString()) &&
            query.findTournamentId(tournamentData[0].toString(), query.value("id").toUInt()) )
         {
             unsigned int tournamentId = query.value("id").toUInt();
-            query.findTournamentLeaderboard(tournamentId);
 
-            if(query.next())
-                sendParticipantsInChunks(query, Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD);
+            // The leaderboard of a finished tournament is final, so its reply is kept as encoded frames.
+            bool cacheable = !query.tournamentIsOpened(tournamentId);
+            unsigned int version = responses->getVersion(Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD, tournamentId);
+
+            if(cacheable && replyFromCache(Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD, tournamentId, version))
+                return;
+
+            loadLeaderboard(query, tournamentId);
+
+            QVector<LeaderboardEntry> participants =
+                leaderboards->findTop(tournamentId, leaderboards->numberOfParticipants(tournamentId));
+
+            if(participants.size() > 0)
+            {
+                if(cacheable)
+                    startRecordingReplies();
+
+                sendParticipantsInChunks(participants, Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD);
+
+                if(cacheable)
+                    finishRecordingReplies(Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD, tournamentId, version);
+            }
             else
             {
                 responseData << Packet::ID_ERROR << QString("This tournament has no participants.");
-                emit response(responseData);
+                reply(responseData);
             }
         }
         else
         {
             responseData << Packet::ID_ERROR << QString("This tournament does not exist.");
-            emit response(responseData);
+            reply(responseData);
         }
     }
 
     void PacketProcessor::manageDownloadingRoundLeaderboard(const QVariantList & roundData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(roundData[1].toString()) &&
            query.findTournamentId(roundData[0].toString(), query.value("id").toUInt()) )
         {
             unsigned int tournamentId = query.value("id").toUInt();
-            query.findTournamentLeaderboard(tournamentId);
 
             if(query.findRoundId(roundData[2].toString(), tournamentId))
             {
                 unsigned int roundId = query.value("id").toUInt();
                 query.findRoundLeaderboard(tournamentId, roundId);
 
-                if(query.next())
-                    sendParticipantsInChunks(query, Packet::ID_DOWNLOAD_ROUND_LEADERBOARD);
+                QVector<LeaderboardEntry> participants = readLeaderboardEntries(query);
+
+                if(participants.size() > 0)
+                    sendParticipantsInChunks(participants, Packet::ID_DOWNLOAD_ROUND_LEADERBOARD);
                 else
                 {
                     responseData << Packet::ID_ERROR << QString("This tournament has no participants.");
-                    emit response(responseData);
+                    reply(responseData);
                 }
             }
             else
             {
                 responseData << Packet::ID_ERROR << QString("This round does not exist.");
-                emit response(responseData);
+                reply(responseData);
             }
         }
         else
         {
             responseData << Packet::ID_ERROR << QString("This tournament does not exist.");
-            emit response(responseData);
+            reply(responseData);
         }
     }
 
-    void PacketProcessor::sendParticipantsInChunks(QSqlQuery & query, const int packetId)
+    void PacketProcessor::manageDownloadingLeaderboardRank(const QVariantList & requestData)
     {
+        Query query(dbConnection);
         QVariantList responseData;
-        int chunkSize = 50;
+        unsigned int tournamentId = requestData[0].toUInt();
+        LeaderboardEntry participant;
+
+        loadLeaderboard(query, tournamentId);
+        int rank = leaderboards->findRank(tournamentId, requestData[1].toString(), participant);
+
+        if(rank > 0)
+        {
+            responseData << Packet::ID_DOWNLOAD_LEADERBOARD_RANK << tournamentId << rank
+                         << leaderboards->numberOfParticipants(tournamentId) << participant.nickname
+                         << participant.exactScore << participant.predictedResult << participant.points;
+        }
+        else
+            responseData << Packet::ID_ERROR << QString("You are not taking part in this tournament.");
+
+        reply(responseData);
+    }
+
+    void PacketProcessor::manageDownloadingLeaderboardPage(const QVariantList & requestData)
+    {
+        Query query(dbConnection);
+        QVariantList responseData;
+        unsigned int tournamentId = requestData[0].toUInt();
+        int firstRank = qMax(1, requestData[1].toInt());
+        int count = qBound(1, requestData[2].toInt(), LEADERBOARD_PAGE_LIMIT);
+
+        loadLeaderboard(query, tournamentId);
+        QVector<LeaderboardEntry> participants = leaderboards->findEntries(tournamentId, firstRank, count);
+
+        responseData << Packet::ID_DOWNLOAD_LEADERBOARD_PAGE << tournamentId << firstRank
+                     << leaderboards->numberOfParticipants(tournamentId);
+
+        for(auto participant : participants)
+        {
+            QVariantList leaderboardData;
+            leaderboardData << participant.nickname << participant.exactScore << participant.predictedResult
+                            << participant.points;
+            responseData << QVariant::fromValue(leaderboardData);
+        }
+
+        reply(responseData);
+    }
+
+    void PacketProcessor::loadLeaderboard(Query & query, unsigned int tournamentId)
+    {
+        if(leaderboards->contains(tournamentId))
+            return;
+
+        unsigned int version = leaderboards->getVersion(tournamentId);
+        query.findTournamentLeaderboard(tournamentId);
+
+        QVector<LeaderboardEntry> participants = readLeaderboardEntries(query);
+
+        if(participants.size() > 0)
+            leaderboards->setLeaderboard(tournamentId, participants, version);
+    }
+
+    void PacketProcessor::settleScores()
+    {
+        Query query(dbConnection);
+        QList<QPair<unsigned int, unsigned int> > unsettledRounds;
+        query.findUnsettledRounds();
+
+        while(query.next())
+            unsettledRounds << qMakePair(query.value("tournament_id").toUInt(), query.value("round_id").toUInt());
+
+        for(auto round : unsettledRounds)
+            refreshRoundScores(query, round.first, round.second);
+    }
+
+    void PacketProcessor::refreshRoundScores(Query & query, unsigned int tournamentId, unsigned int roundId)
+    {
+        query.refreshRoundScores(roundId);
+        leaderboards->invalidate(tournamentId);
+        responses->invalidate(Packet::ID_DOWNLOAD_TOURNAMENT_LEADERBOARD, tournamentId);
+        responses->invalidate(Packet::ID_PULL_MATCHES, roundId);
+    }
+
+    QVector<LeaderboardEntry> PacketProcessor::readLeaderboardEntries(QSqlQuery & query)
+    {
+        QVector<LeaderboardEntry> participants;
+
+        while(query.next())
+        {
+            participants << LeaderboardEngine::createEntry(query.value("nickname").toString(),
+                                                           query.value("exact_score").toUInt(),
+                                                           query.value("predicted_result").toUInt());
+        }
+
+        return participants;
+    }
+
+    void PacketProcessor::sendParticipantsInChunks(const QVector<LeaderboardEntry> & participants, const int packetId)
+    {
+        QSharedPointer<ChunkStream> stream(new ChunkStream);
+        stream->channel = replyChannel;
+        stream->packetId = packetId;
+        stream->chunkSize = PARTICIPANTS_CHUNK_SIZE;
+
         int i = 0;
+        stream->readRow = [participants, i](QVariantList & leaderboardData) mutable
+        {
+            if(i == participants.size())
+                return false;
+
+            const LeaderboardEntry & participant = participants.at(i++);
+            leaderboardData << participant.nickname
+                            << participant.exactScore
+                            << participant.predictedResult
+                            << participant.points;
+            return true;
+        };
+
+        streamChunks(stream);
+    }
 
-        do
+    void PacketProcessor::streamChunks(QSharedPointer<ChunkStream> stream)
+    {
+        QVariantList responseData;
+        QVariantList rowData;
+        responseData << stream->packetId;
+
+        while(stream->readRow(rowData))
         {
-            if(i == chunkSize)
+            responseData << QVariant::fromValue(rowData);
+            rowData.clear();
+
+            if(responseData.size() > stream->chunkSize)
             {
-                emit response(responseData);
+                reply(responseData);
                 responseData.clear();
-                i = 0;
+                responseData << stream->packetId;
+
+                if(replyChannel->isCongested())
+                {
+                    // Re-check after asking for the notification, the socket may have drained in between.
+                    replyChannel->requestDrainNotification();
+
+                    if(replyChannel->isCongested())
+                    {
+                        pausedStreams.insert(replyChannel->getConnectionId(), stream);
+                        return;
+                    }
+                }
             }
+        }
 
-            if(i == 0)
-                responseData << packetId;
+        if(responseData.size() > 1)
+            reply(responseData);
 
-            QVariantList leaderboardData;
-            leaderboardData << query.value("nickname")
-                            << query.value("exact_score")
-                            << query.value("predicted_result")
-                            << query.value("points");
-            responseData << QVariant::fromValue(leaderboardData);
+        if(!stream->trailer.isEmpty())
+            reply(stream->trailer);
 
-            i++;
-        } while(query.next());
+        if(pausedStreams.remove(replyChannel->getConnectionId()) > 0)
+            replyChannel->finish();
+    }
 
-        emit response(responseData);
+    void PacketProcessor::resumeChunkStream(quint64 connectionId)
+    {
+        if(!pausedStreams.contains(connectionId))
+            return;
+
+        QSharedPointer<ChunkStream> stream = pausedStreams.value(connectionId);
+        replyChannel = stream->channel;
+        streamChunks(stream);
+        replyChannel.reset();
+    }
+
+    void PacketProcessor::dropChunkStream(quint64 connectionId)
+    {
+        pausedStreams.remove(connectionId);
+    }
+
+    std::function<bool (QVariantList &)> PacketProcessor::createRowReader(PageReader readPage, int pageSize,
+                                                                          const QList<QVariantList> & firstPage)
+    {
+        // Rows are fetched a page at a time and every page query is finished before its rows are sent,
+        // so a stream paused by a slow client holds no statement or read snapshot on the connection.
+        QList<QVariantList> page = firstPage;
+        bool lastPage = firstPage.size() < pageSize;
+
+        return [readPage, pageSize, page, lastPage](QVariantList & rowData) mutable
+        {
+            if(page.isEmpty() && !lastPage)
+            {
+                page = readPage(pageSize);
+                lastPage = page.size() < pageSize;
+            }
+
+            if(page.isEmpty())
+                return false;
+
+            rowData = page.takeFirst();
+            return true;
+        };
     }
 
     void PacketProcessor::managePullingMatches(const QVariantList & requestData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(requestData[1].toString()) &&
            query.findTournamentId(requestData[0].toString(), query.value("id").toUInt()) &&
            query.findRoundId(requestData[2].toString(), query.value("id").toUInt()) )
         {
-            unsigned int roundId = query.value("id").toUInt();
-            query.findMatches(roundId);
-            bool matchesFound = true;
+            pullMatches(query, query.value("id").toUInt());
+        }
+        else
+        {
+            responseData << Packet::ID_ERROR << QString("This round does not exist.");
+            reply(responseData);
+        }
+    }
 
-            if(!query.next())
-            {
-                responseData << Packet::ID_ZERO_MATCHES_TO_PULL;
-                emit response(responseData);
-                matchesFound = false;
-            }
-            else
-                sendMatchesInChunks(query);
+    void PacketProcessor::managePullingMatchesById(const QVariantList & requestData)
+    {
+        Query query(dbConnection);
+        unsigned int roundId = requestData[0].toUInt();
 
-            if(matchesFound)
-            {
-                responseData.clear();
-                responseData << Packet::ID_ALL_MATCHES_PULLED;
-                emit response(responseData);
-            }
-        }
+        if(query.roundExists(roundId))
+            pullMatches(query, roundId);
         else
         {
+            QVariantList responseData;
             responseData << Packet::ID_ERROR << QString("This round does not exist.");
-            emit response(responseData);
+            reply(responseData);
         }
     }
 
-    void PacketProcessor::sendMatchesInChunks(QSqlQuery & query)
+    void PacketProcessor::pullMatches(Query & query, unsigned int roundId)
     {
         QVariantList responseData;
-        int chunkSize = 40;
-        int i = 0;
 
-        do
+        // Matches of a closed tournament can't be changed any more, so their reply is kept as encoded frames.
+        bool cacheable = query.roundIsClosed(roundId);
+        unsigned int version = responses->getVersion(Packet::ID_PULL_MATCHES, roundId);
+
+        if(cacheable && replyFromCache(Packet::ID_PULL_MATCHES, roundId, version))
+            return;
+
+        if(cacheable)
+            startRecordingReplies();
+
+        PageReader readPage = createMatchesPageReader(roundId);
+        QList<QVariantList> firstPage = readPage(MATCHES_CHUNK_SIZE);
+
+        if(firstPage.isEmpty())
         {
-            if(i == chunkSize)
+            responseData << Packet::ID_ZERO_MATCHES_TO_PULL;
+            reply(responseData);
+        }
+        else
+        {
+            responseData << Packet::ID_ALL_MATCHES_PULLED;
+            sendMatchesInChunks(readPage, firstPage, responseData);
+        }
+
+        if(cacheable)
+            finishRecordingReplies(Packet::ID_PULL_MATCHES, roundId, version);
+    }
+
+    PacketProcessor::PageReader PacketProcessor::createMatchesPageReader(unsigned int roundId)
+    {
+        QSharedPointer<DbConnection> connection = dbConnection;
+        unsigned int lastMatchId = 0;
+
+        // A null QString is bound as NULL, which no row compares greater than; an empty one sorts before every time.
+        QString lastEndTime("");
+
+        // Each page continues after the last row of the previous one, (predictions_end_time, id) orders rows uniquely.
+        return [connection, roundId, lastEndTime, lastMatchId](int limit) mutable
+        {
+            QList<QVariantList> page;
+            Query query(connection);
+            query.findMatches(roundId, lastEndTime, lastMatchId, limit);
+
+            while(query.next())
             {
-                emit response(responseData);
-                responseData.clear();
-                i = 0;
-            }
+                QVariantList matchData;
+                readMatch(query, matchData);
+                page << matchData;
 
-            if(i == 0)
-                responseData << Packet::ID_PULL_MATCHES;
+                lastEndTime = query.value("predictions_end_time").toString();
+                lastMatchId = query.value("id").toUInt();
+            }
 
-            QVariantList matchData;
-            matchData << query.value("competitor_1")
-                      << query.value("competitor_2")
-                      << query.value("competitor_1_score")
-                      << query.value("competitor_2_score")
-                      << query.value("predictions_end_time").toDateTime().toString("dd.MM.yyyy hh:mm");
-            responseData << QVariant::fromValue(matchData);
+            return page;
+        };
+    }
 
-            i++;
-        } while(query.next());
+    void PacketProcessor::sendMatchesInChunks(PageReader readPage, const QList<QVariantList> & firstPage,
+                                              const QVariantList & trailer)
+    {
+        QSharedPointer<ChunkStream> stream(new ChunkStream);
+        stream->channel = replyChannel;
+        stream->packetId = Packet::ID_PULL_MATCHES;
+        stream->chunkSize = MATCHES_CHUNK_SIZE;
+        stream->readRow = createRowReader(readPage, MATCHES_CHUNK_SIZE, firstPage);
+        stream->trailer = trailer;
+
+        streamChunks(stream);
+    }
 
-        emit response(responseData);
+    void PacketProcessor::readMatch(QSqlQuery & query, QVariantList & matchData)
+    {
+        matchData << query.value("competitor_1")
+                  << query.value("competitor_2")
+                  << query.value("competitor_1_score")
+                  << query.value("competitor_2_score")
+                  << query.value("predictions_end_time").toDateTime().toString("dd.MM.yyyy hh:mm")
+                  << query.value("id").toUInt();
     }
 
     void PacketProcessor::manageCreatingNewMatch(const QVariantList & matchData)
     {
         Match match(matchData[0].value<QVariantList>());
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(match.getTournamentHostName()) &&
@@ -702,7 +1085,11 @@ namespace Server
 
                 else if(query.createMatch(roundId, match.getFirstCompetitor(), match.getSecondCompetitor(),
                                           match.getPredictionsEndTime()))
-                    responseData << true << QString("The match was created successfully.");
+                {
+                    responses->invalidate(Packet::ID_PULL_MATCHES, roundId);
+                    responseData << true << QString("The match was created successfully.")
+                                 << query.lastInsertId().toUInt();
+                }
                 else
                     responseData << false << QString("The match couldn't be created. Try again later.");
             }
@@ -710,13 +1097,13 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("This tournament does not exist.");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageDeletingMatch(const QVariantList & matchData)
     {
         Match match(matchData[0].value<QVariantList>());
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(match.getTournamentHostName()) &&
@@ -734,7 +1121,10 @@ namespace Server
                 unsigned int roundId = query.value("id").toUInt();
 
                 if(query.deleteMatch(roundId, match.getFirstCompetitor(), match.getSecondCompetitor()))
+                {
+                    refreshRoundScores(query, tournamentId, roundId);
                     responseData << Packet::ID_MATCH_DELETED << match.getFirstCompetitor() << match.getSecondCompetitor();
+                }
                 else
                     responseData << Packet::ID_MATCH_DELETING_ERROR
                                  << QString("The match couldn't be deleted. Try again later.");
@@ -743,13 +1133,13 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("This tournament does not exist.");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageUpdatingMatchScore(const QVariantList & matchData)
     {
         Match match(matchData[0].value<QVariantList>());
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(query.findUserId(match.getTournamentHostName()) &&
@@ -772,6 +1162,8 @@ namespace Server
 
                     if(query.updateMatchScore(matchId, match.getFirstCompetitorScore(), match.getSecondCompetitorScore()))
                     {
+                        refreshRoundScores(query, tournamentId, roundId);
+
                         QVariantList updatedMatchData;
                         updatedMatchData << match.getFirstCompetitor() << match.getSecondCompetitor()
                                          << match.getFirstCompetitorScore()
@@ -790,18 +1182,56 @@ namespace Server
         else
             responseData << Packet::ID_ERROR << QString("This tournament does not exist.");
 
-        emit response(responseData);
+        reply(responseData);
+    }
+
+    void PacketProcessor::manageUpdatingMatchScoreById(const QVariantList & matchData)
+    {
+        Query query(dbConnection);
+        QVariantList responseData;
+        unsigned int matchId = matchData[1].toUInt();
+        unsigned int firstCompetitorScore = matchData[2].toUInt();
+        unsigned int secondCompetitorScore = matchData[3].toUInt();
+
+        if(!query.findMatchContext(matchId) || query.value("host_name").toString() != matchData[0].toString())
+            responseData << Packet::ID_MATCH_SCORE_UPDATE_ERROR << QString("This match does not exist.");
+
+        else if(!query.value("opened").toBool())
+            responseData << Packet::ID_MATCH_SCORE_UPDATE_ERROR << QString("This tournament is closed.");
+        else
+        {
+            unsigned int tournamentId = query.value("tournament_id").toUInt();
+            unsigned int roundId = query.value("round_id").toUInt();
+            QString firstCompetitor = query.value("competitor_1").toString();
+            QString secondCompetitor = query.value("competitor_2").toString();
+
+            if(query.updateMatchScore(matchId, firstCompetitorScore, secondCompetitorScore))
+            {
+                refreshRoundScores(query, tournamentId, roundId);
+
+                QVariantList updatedMatchData;
+                updatedMatchData << firstCompetitor << secondCompetitor << firstCompetitorScore
+                                 << secondCompetitorScore;
+
+                responseData << Packet::ID_MATCH_SCORE_UPDATED << QVariant::fromValue(updatedMatchData);
+            }
+            else
+                responseData << Packet::ID_MATCH_SCORE_UPDATE_ERROR
+                             << QString("The score couldn't be udpated. Try again later.");
+        }
+
+        reply(responseData);
     }
 
     void PacketProcessor::managePullingMatchesPredictions(const QVariantList & requestData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(!query.findUserId(requestData[0].toString()))
         {
             responseData << Packet::ID_ERROR << QString("User does not exist.");
-            emit response(responseData);
+            reply(responseData);
             return;
         }
 
@@ -815,13 +1245,14 @@ namespace Server
             if(query.findRoundId(requestData[3].toString(), tournamentId))
             {
                 unsigned int roundId = query.value("id").toUInt();
-                query.findMatchesPredictions(tournamentId, roundId, requesterId);
-
-                if(query.next())
-                    sendMatchesPredictionsInChunks(query);
-
+                PageReader readPage = createMatchesPredictionsPageReader(tournamentId, roundId, requesterId);
+                QList<QVariantList> firstPage = readPage(MATCHES_CHUNK_SIZE);
                 responseData << Packet::ID_ALL_MATCHES_PREDICTIONS_PULLED;
-                emit response(responseData);
+
+                if(!firstPage.isEmpty())
+                    sendMatchesPredictionsInChunks(readPage, firstPage, responseData);
+                else
+                    reply(responseData);
             }
             else
                 responseData << Packet::ID_ERROR << QString("This round does not exist.");
@@ -829,51 +1260,73 @@ namespace Server
         else
         {
             responseData << Packet::ID_ERROR << QString("This tournament does not exist.");
-            emit response(responseData);
+            reply(responseData);
         }
     }
 
-    void PacketProcessor::sendMatchesPredictionsInChunks(QSqlQuery & query)
+    PacketProcessor::PageReader PacketProcessor::createMatchesPredictionsPageReader(unsigned int tournamentId,
+                                                                                   unsigned int roundId,
+                                                                                   unsigned int requesterId)
     {
-        QVariantList responseData;
-        int chunkSize = 40;
-        int i = 0;
+        QSharedPointer<DbConnection> connection = dbConnection;
+        QString lastEndTime("");
+        unsigned int lastMatchId = 0;
+        unsigned int lastPredictionId = 0;
 
-        do
+        return [connection, tournamentId, roundId, requesterId,
+                lastEndTime, lastMatchId, lastPredictionId](int limit) mutable
         {
-            if(i == chunkSize)
+            QList<QVariantList> page;
+            Query query(connection);
+            query.findMatchesPredictions(tournamentId, roundId, requesterId, lastEndTime, lastMatchId, lastPredictionId,
+                                         limit);
+
+            while(query.next())
             {
-                emit response(responseData);
-                responseData.clear();
-                i = 0;
-            }
+                QVariantList predictionsData;
+                readMatchPrediction(query, predictionsData);
+                page << predictionsData;
 
-            if(i == 0)
-                responseData << Packet::ID_PULL_MATCHES_PREDICTIONS;
+                lastEndTime = query.value("predictions_end_time").toString();
+                lastMatchId = query.value("match_id").toUInt();
+                lastPredictionId = query.value("prediction_id").toUInt();
+            }
 
-            QVariantList predictionsData;
-            predictionsData << query.value("nickname")
-                            << query.value("competitor_1_score_prediction")
-                            << query.value("competitor_2_score_prediction")
-                            << query.value("competitor_1")
-                            << query.value("competitor_2");
-            responseData << QVariant::fromValue(predictionsData);
+            return page;
+        };
+    }
 
-            i++;
-        } while(query.next());
+    void PacketProcessor::sendMatchesPredictionsInChunks(PageReader readPage, const QList<QVariantList> & firstPage,
+                                                         const QVariantList & trailer)
+    {
+        QSharedPointer<ChunkStream> stream(new ChunkStream);
+        stream->channel = replyChannel;
+        stream->packetId = Packet::ID_PULL_MATCHES_PREDICTIONS;
+        stream->chunkSize = MATCHES_CHUNK_SIZE;
+        stream->readRow = createRowReader(readPage, MATCHES_CHUNK_SIZE, firstPage);
+        stream->trailer = trailer;
+
+        streamChunks(stream);
+    }
 
-        emit response(responseData);
+    void PacketProcessor::readMatchPrediction(QSqlQuery & query, QVariantList & predictionsData)
+    {
+        predictionsData << query.value("nickname")
+                        << query.value("competitor_1_score_prediction")
+                        << query.value("competitor_2_score_prediction")
+                        << query.value("competitor_1")
+                        << query.value("competitor_2");
     }
 
     void PacketProcessor::manageMakingPrediction(const QVariantList & predictionData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(!query.findUserId(predictionData[0].toString()))
         {
             responseData << Packet::ID_ERROR << QString("User does not exist.");
-            emit response(responseData);
+            reply(responseData);
             return;
         }
 
@@ -929,18 +1382,18 @@ namespace Server
         else
             responseData << Packet::ID_MAKE_PREDICTION_ERROR << QString("This tournament does not exist.");
 
-        emit response(responseData);
+        reply(responseData);
     }
 
     void PacketProcessor::manageUpdatingPrediction(const QVariantList & predictionData)
     {
-        Query query(dbConnection->getConnection());
+        Query query(dbConnection);
         QVariantList responseData;
 
         if(!query.findUserId(predictionData[0].toString()))
         {
             responseData << Packet::ID_ERROR << QString("User does not exist.");
-            emit response(responseData);
+            reply(responseData);
             return;
         }
 
@@ -996,6 +1449,87 @@ namespace Server
         else
             responseData << Packet::ID_UPDATE_PREDICTION_ERROR << QString("This tournament does not exist.");
 
-        emit response(responseData);
+        reply(responseData);
+    }
+
+    void PacketProcessor::manageMakingPredictionById(const QVariantList & predictionData)
+    {
+        Query query(dbConnection);
+        QVariantList responseData;
+        unsigned int matchId = predictionData[1].toUInt();
+        unsigned int firstCompetitorScore = predictionData[2].toUInt();
+        unsigned int secondCompetitorScore = predictionData[3].toUInt();
+
+        if(!query.findPredictionContext(matchId, predictionData[0].toString()))
+            responseData << Packet::ID_MAKE_PREDICTION_ERROR << QString("This match does not exist.");
+
+        else if(!query.value("opened").toBool())
+            responseData << Packet::ID_MAKE_PREDICTION_ERROR << QString("This tournament is closed.");
+
+        else if(query.value("participant_id").isNull())
+            responseData << Packet::ID_MAKE_PREDICTION_ERROR << QString("You are not taking part in this tournament.");
+
+        else if(!query.value("accepting_predictions").toBool())
+            responseData << Packet::ID_MAKE_PREDICTION_ERROR
+                         << QString("The time to predict the result of this match has come to an end.");
+
+        else if(query.value("predictions_made").toUInt() > 0)
+            responseData << Packet::ID_MAKE_PREDICTION_ERROR
+                         << QString("You have already predicted the result of this match.");
+        else
+        {
+            unsigned int participantId = query.value("participant_id").toUInt();
+            QString firstCompetitor = query.value("competitor_1").toString();
+            QString secondCompetitor = query.value("competitor_2").toString();
+
+            if(query.createMatchPrediction(matchId, participantId, firstCompetitorScore, secondCompetitorScore))
+                responseData << Packet::ID_MAKE_PREDICTION << predictionData[0] << firstCompetitor
+                             << secondCompetitor << firstCompetitorScore << secondCompetitorScore;
+            else
+                responseData << Packet::ID_MAKE_PREDICTION_ERROR << QString("The prediction could not have been made.");
+        }
+
+        reply(responseData);
+    }
+
+    void PacketProcessor::manageUpdatingPredictionById(const QVariantList & predictionData)
+    {
+        Query query(dbConnection);
+        QVariantList responseData;
+        unsigned int matchId = predictionData[1].toUInt();
+        unsigned int firstCompetitorScore = predictionData[2].toUInt();
+        unsigned int secondCompetitorScore = predictionData[3].toUInt();
+
+        if(!query.findPredictionContext(matchId, predictionData[0].toString()))
+            responseData << Packet::ID_UPDATE_PREDICTION_ERROR << QString("This match does not exist.");
+
+        else if(!query.value("opened").toBool())
+            responseData << Packet::ID_UPDATE_PREDICTION_ERROR << QString("This tournament is closed.");
+
+        else if(query.value("participant_id").isNull())
+            responseData << Packet::ID_UPDATE_PREDICTION_ERROR << QString("You are not taking part in this tournament.");
+
+        else if(!query.value("accepting_predictions").toBool())
+            responseData << Packet::ID_UPDATE_PREDICTION_ERROR
+                         << QString("The time to predict the result of this match has come to an end.");
+
+        else if(query.value("predictions_made").toUInt() == 0)
+            responseData << Packet::ID_UPDATE_PREDICTION_ERROR
+                         << QString("You have not made a result prediction for this match yet.");
+        else
+        {
+            unsigned int participantId = query.value("participant_id").toUInt();
+            QString firstCompetitor = query.value("competitor_1").toString();
+            QString secondCompetitor = query.value("competitor_2").toString();
+
+            if(query.updateMatchPrediction(matchId, participantId, firstCompetitorScore, secondCompetitorScore))
+                responseData << Packet::ID_UPDATE_PREDICTION << predictionData[0] << firstCompetitor
+                             << secondCompetitor << firstCompetitorScore << secondCompetitorScore;
+            else
+                responseData << Packet::ID_UPDATE_PREDICTION_ERROR
+                             << QString("The prediction could not have been updated.");
+        }
+
+        reply(responseData);
     }
 }
@@ -8,8 +8,16 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
+#include <QHash>
+#include <functional>
 #include <packet.h>
 #include <dbconnection.h>
+#include <replychannel.h>
+#include <leaderboardengine.h>
+#include <tournamentsearchindex.h>
+#include <avatarstore.h>
+#include <responsecache.h>
+#include <servermetrics.h>
 #include <../ScorePredictorClient/tournament.h>
 #include <../ScorePredictorClient/match.h>
 
@@ -20,12 +28,44 @@ namespace Server
         Q_OBJECT
 
     private:
+        typedef std::function<QList<QVariantList> (int)> PageReader;
+
+        struct ChunkStream
+        {
+            int packetId;
+            int chunkSize;
+            std::function<bool (QVariantList &)> readRow;
+            QVariantList trailer;
+            QSharedPointer<ReplyChannel> channel;
+        };
+
         QSharedPointer<DbConnection> dbConnection;
+        QSharedPointer<LeaderboardEngine> leaderboards;
+        QSharedPointer<TournamentSearchIndex> tournamentSearch;
+        QSharedPointer<AvatarStore> avatars;
+        QSharedPointer<ResponseCache> responses;
+        QSharedPointer<ReplyChannel> replyChannel;
+        QHash<quint64, QSharedPointer<ChunkStream> > pausedStreams;
+        QList<QPair<QSharedPointer<ReplyChannel>, QVariantList> > bufferedReplies;
+        QList<QSharedPointer<ReplyChannel> > finishedChannels;
+        bool replyBuffering;
+        bool replyRecording;
+        QList<ResponseFrame> recordedReplies;
+        int recordedBytes;
+        int currentPacketId;
 
-        const static QString STARTING_MESSAGE_PATH;
         const static QString DEFAULT_AVATAR_PATH;
+        const static int LEADERBOARD_PAGE_LIMIT;
+        const static int MATCHES_CHUNK_SIZE;
+        const static int PARTICIPANTS_CHUNK_SIZE;
+
+        void dispatchPacket(const Packet & packet);
+        void reply(const QVariantList & data);
+        void recordReply(const QVariantList & data);
+        bool replyFromCache(int packetId, unsigned int entityId, unsigned int version);
+        void startRecordingReplies();
+        void finishRecordingReplies(int packetId, unsigned int entityId, unsigned int version);
 
-        void manageDownloadingStartingMessage();
         void registerUser(const QVariantList & userData);
         void loginUser(const QVariantList & userData);
 
@@ -46,30 +86,56 @@ namespace Server
 
         void manageDownloadingTournamentLeaderboard(const QVariantList & tournamentData);
         void manageDownloadingRoundLeaderboard(const QVariantList & roundData);
+        void manageDownloadingLeaderboardRank(const QVariantList & requestData);
+        void manageDownloadingLeaderboardPage(const QVariantList & requestData);
 
         void managePullingMatches(const QVariantList & requestData);
+        void managePullingMatchesById(const QVariantList & requestData);
+        void pullMatches(Query & query, unsigned int roundId);
         void manageCreatingNewMatch(const QVariantList & matchData);
         void manageDeletingMatch(const QVariantList & matchData);
         void manageUpdatingMatchScore(const QVariantList & matchData);
+        void manageUpdatingMatchScoreById(const QVariantList & matchData);
 
         void managePullingMatchesPredictions(const QVariantList & requestData);
         void manageMakingPrediction(const QVariantList & predictionData);
         void manageUpdatingPrediction(const QVariantList & predictionData);
+        void manageMakingPredictionById(const QVariantList & predictionData);
+        void manageUpdatingPredictionById(const QVariantList & predictionData);
 
         QString validateTournamentJoining(unsigned int tournamentId, unsigned int userId);
-        void sendParticipantsInChunks(QSqlQuery & query, const int packetId);
-        void sendMatchesInChunks(QSqlQuery & query);
-        void sendMatchesPredictionsInChunks(QSqlQuery & query);
+        void loadLeaderboard(Query & query, unsigned int tournamentId);
+        void refreshRoundScores(Query & query, unsigned int tournamentId, unsigned int roundId);
+        QVector<LeaderboardEntry> readLeaderboardEntries(QSqlQuery & query);
+        void sendParticipantsInChunks(const QVector<LeaderboardEntry> & participants, const int packetId);
+        void streamChunks(QSharedPointer<ChunkStream> stream);
+        static std::function<bool (QVariantList &)> createRowReader(PageReader readPage, int pageSize,
+                                                                    const QList<QVariantList> & firstPage);
+        PageReader createMatchesPageReader(unsigned int roundId);
+        void sendMatchesInChunks(PageReader readPage, const QList<QVariantList> & firstPage,
+                                 const QVariantList & trailer);
+        static void readMatch(QSqlQuery & query, QVariantList & matchData);
+        PageReader createMatchesPredictionsPageReader(unsigned int tournamentId, unsigned int roundId,
+                                                      unsigned int requesterId);
+        void sendMatchesPredictionsInChunks(PageReader readPage, const QList<QVariantList> & firstPage,
+                                            const QVariantList & trailer);
+        static void readMatchPrediction(QSqlQuery & query, QVariantList & predictionsData);
 
     public:
-        explicit PacketProcessor(QSharedPointer<DbConnection> connection, QObject * parent = nullptr);
+        explicit PacketProcessor(QSharedPointer<DbConnection> connection,
+                                 QSharedPointer<LeaderboardEngine> leaderboardEngine,
+                                 QSharedPointer<TournamentSearchIndex> searchIndex,
+                                 QSharedPointer<AvatarStore> avatarStore,
+                                 QSharedPointer<ResponseCache> responseCache, QObject * parent = nullptr);
         ~PacketProcessor() {}
 
-    public slots:
-        void processPacket(const Packet & packet);
-
-    signals:
-        void response(const QVariantList & data);
+        void processRequest(const Packet & packet, QSharedPointer<ReplyChannel> channel);
+        void setReplyBuffering(bool enabled);
+        void flushBufferedReplies();
+        void discardBufferedReplies();
+        void settleScores();
+        void resumeChunkStream(quint64 connectionId);
+        void dropChunkStream(quint64 connectionId);
     };
 }
 
@@ -0,0 +1,84 @@
+#include "poolacceptor.h"
+
+#if defined(Q_OS_UNIX)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+PoolAcceptor::PoolAcceptor(QObject * parent) : QTcpServer(parent)
+{
+
+}
+
+void PoolAcceptor::incomingConnection(qintptr descriptor)
+{
+    emit connectionAccepted(descriptor);
+}
+
+bool PoolAcceptor::listenShared(const QHostAddress & address, quint16 port)
+{
+    qintptr descriptor = openSharedSocket(address, port);
+
+    if(descriptor == -1)
+        return false;
+
+    return setSocketDescriptor(descriptor);
+}
+
+qintptr PoolAcceptor::openSharedSocket(const QHostAddress & address, quint16 port)
+{
+#if defined(Q_OS_UNIX) && defined(SO_REUSEPORT)
+    sockaddr_storage socketAddress;
+    socklen_t socketAddressLength = 0;
+    std::memset(&socketAddress, 0, sizeof(socketAddress));
+
+    bool dualStack = address == QHostAddress::Any;
+
+    if(dualStack || address.protocol() == QAbstractSocket::IPv6Protocol)
+    {
+        sockaddr_in6 * ipv6Address = reinterpret_cast<sockaddr_in6 *>(&socketAddress);
+        Q_IPV6ADDR ip = dualStack ? QHostAddress(QHostAddress::AnyIPv6).toIPv6Address() : address.toIPv6Address();
+        ipv6Address->sin6_family = AF_INET6;
+        ipv6Address->sin6_port = htons(port);
+        std::memcpy(&ipv6Address->sin6_addr, &ip, sizeof(ip));
+        socketAddressLength = sizeof(sockaddr_in6);
+    }
+    else
+    {
+        sockaddr_in * ipv4Address = reinterpret_cast<sockaddr_in *>(&socketAddress);
+        ipv4Address->sin_family = AF_INET;
+        ipv4Address->sin_port = htons(port);
+        ipv4Address->sin_addr.s_addr = htonl(address.toIPv4Address());
+        socketAddressLength = sizeof(sockaddr_in);
+    }
+
+    int descriptor = ::socket(socketAddress.ss_family, SOCK_STREAM, 0);
+
+    if(descriptor < 0)
+        return -1;
+
+    int enabled = 1;
+    int disabled = 0;
+
+    // Every socket bound to the port needs SO_REUSEPORT, the kernel then spreads accepts between them.
+    if(::setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled)) != 0 ||
+       ::setsockopt(descriptor, SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled)) != 0 ||
+       (dualStack && ::setsockopt(descriptor, IPPROTO_IPV6, IPV6_V6ONLY, &disabled, sizeof(disabled)) != 0) ||
+       ::bind(descriptor, reinterpret_cast<sockaddr *>(&socketAddress), socketAddressLength) != 0 ||
+       ::listen(descriptor, SOMAXCONN) != 0)
+    {
+        ::close(descriptor);
+        return -1;
+    }
+
+    return descriptor;
+#else
+    Q_UNUSED(address)
+    Q_UNUSED(port)
+
+    return -1;
+#endif
+}
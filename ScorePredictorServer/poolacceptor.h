@@ -0,0 +1,25 @@
+#ifndef POOLACCEPTOR_H
+#define POOLACCEPTOR_H
+
+#include <QTcpServer>
+
+class PoolAcceptor : public QTcpServer
+{
+    Q_OBJECT
+
+protected:
+    void incomingConnection(qintptr descriptor);
+
+public:
+    explicit PoolAcceptor(QObject * parent = nullptr);
+    ~PoolAcceptor() {}
+
+    bool listenShared(const QHostAddress & address, quint16 port);
+
+    static qintptr openSharedSocket(const QHostAddress & address, quint16 port);
+
+signals:
+    void connectionAccepted(qintptr descriptor);
+};
+
+#endif // POOLACCEPTOR_H
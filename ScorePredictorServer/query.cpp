@@ -1,13 +1,60 @@
 #include "query.h"
 
-Query::Query(const QSqlDatabase & dbConnection) : QSqlQuery(dbConnection)
+Query::Query(QSharedPointer<DbConnection> connection) : QSqlQuery(connection->getConnection())
 {
+    dbConnection = connection;
+    currentStatement = NO_STATEMENT;
     setForwardOnly(true);
 }
 
+Query::~Query()
+{
+    releaseStatement();
+}
+
+bool Query::exec()
+{
+    if(QSqlQuery::exec())
+        return true;
+
+    dbConnection->reportError(lastError());
+    return false;
+}
+
+void Query::prepareStatement(Statement statement, const QString & sql)
+{
+    releaseStatement();
+
+    QSqlQuery cachedStatement;
+
+    if(dbConnection->takePreparedStatement(statement, cachedStatement))
+    {
+        QSqlQuery::operator=(cachedStatement);
+        currentStatement = statement;
+        return;
+    }
+
+    QSqlQuery::operator=(QSqlQuery(dbConnection->getConnection()));
+    setForwardOnly(true);
+
+    if(prepare(sql))
+        currentStatement = statement;
+}
+
+void Query::releaseStatement()
+{
+    if(currentStatement == NO_STATEMENT)
+        return;
+
+    finish();
+    dbConnection->returnPreparedStatement(currentStatement, *this);
+    currentStatement = NO_STATEMENT;
+}
+
 bool Query::findUserId(const QString & nickname)
 {
-    prepare("SELECT id FROM user WHERE nickname=:nickname");
+    prepareStatement(STATEMENT_FIND_USER_ID,
+                     "SELECT id FROM user WHERE nickname=:nickname");
     bindValue(":nickname", nickname);
     exec();
 
@@ -16,7 +63,8 @@ bool Query::findUserId(const QString & nickname)
 
 bool Query::isUserRegistered(const QString & nickname)
 {
-    prepare("SELECT 1 FROM user WHERE nickname=:nickname");
+    prepareStatement(STATEMENT_IS_USER_REGISTERED,
+                     "SELECT 1 FROM user WHERE nickname=:nickname");
     bindValue(":nickname", nickname);
     exec();
 
@@ -25,7 +73,8 @@ bool Query::isUserRegistered(const QString & nickname)
 
 bool Query::registerUser(const QString & nickname, const QString & password)
 {
-    prepare("INSERT INTO user(nickname, password) VALUES (:nickname, :password)");
+    prepareStatement(STATEMENT_REGISTER_USER,
+                     "INSERT INTO user(nickname, password) VALUES (:nickname, :password)");
     bindValue(":nickname", nickname);
     bindValue(":password", password);
     exec();
@@ -35,7 +84,8 @@ bool Query::registerUser(const QString & nickname, const QString & password)
 
 bool Query::isPasswordCorrect(const QString & nickname, const QString & password)
 {
-    prepare("SELECT 1 FROM user WHERE nickname=:nickname AND password=:password");
+    prepareStatement(STATEMENT_IS_PASSWORD_CORRECT,
+                     "SELECT 1 FROM user WHERE nickname=:nickname AND password=:password");
     bindValue(":nickname", nickname);
     bindValue(":password", password);
     exec();
@@ -45,9 +95,10 @@ bool Query::isPasswordCorrect(const QString & nickname, const QString & password
 
 bool Query::getUserInfo(const QString & nickname)
 {
-    prepare("SELECT description, avatar_path FROM user "
-            "INNER JOIN user_profile on user.id = user_profile.user_id "
-            "WHERE user.nickname=:nickname");
+    prepareStatement(STATEMENT_GET_USER_INFO,
+                     "SELECT description, avatar_path FROM user "
+                     "INNER JOIN user_profile on user.id = user_profile.user_id "
+                     "WHERE user.nickname=:nickname");
     bindValue(":nickname", nickname);
     exec();
 
@@ -56,11 +107,12 @@ bool Query::getUserInfo(const QString & nickname)
 
 void Query::findUserTournaments(unsigned int userId, bool opened)
 {
-    prepare("SELECT tournament.name, user.nickname AS host_name FROM tournament "
-            "INNER JOIN user ON tournament.host_user_id = user.id "
-            "WHERE tournament.opened = :opened AND tournament.id IN "
-            "(SELECT tournament_id FROM tournament_participant WHERE user_id = :userId) "
-            "ORDER BY entries_end_time desc ");
+    prepareStatement(STATEMENT_FIND_USER_TOURNAMENTS,
+                     "SELECT tournament.name, user.nickname AS host_name FROM tournament "
+                     "INNER JOIN user ON tournament.host_user_id = user.id "
+                     "WHERE tournament.opened = :opened AND tournament.id IN "
+                     "(SELECT tournament_id FROM tournament_participant WHERE user_id = :userId) "
+                     "ORDER BY entries_end_time desc ");
     bindValue(":userId", userId);
     bindValue(":opened", opened);
     exec();
@@ -68,7 +120,8 @@ void Query::findUserTournaments(unsigned int userId, bool opened)
 
 bool Query::updateUserProfileDescription(unsigned int userId, const QString & description)
 {
-    prepare("UPDATE user_profile SET description = :description WHERE user_id = :userId");
+    prepareStatement(STATEMENT_UPDATE_USER_PROFILE_DESCRIPTION,
+                     "UPDATE user_profile SET description = :description WHERE user_id = :userId");
     bindValue(":description", description);
     bindValue(":userId", userId);
     exec();
@@ -78,7 +131,8 @@ bool Query::updateUserProfileDescription(unsigned int userId, const QString & de
 
 bool Query::findUserProfileAvatarPath(unsigned int userId)
 {
-    prepare("SELECT avatar_path FROM user_profile WHERE user_id = :userId");
+    prepareStatement(STATEMENT_FIND_USER_PROFILE_AVATAR_PATH,
+                     "SELECT avatar_path FROM user_profile WHERE user_id = :userId");
     bindValue(":userId", userId);
     exec();
 
@@ -87,7 +141,8 @@ bool Query::findUserProfileAvatarPath(unsigned int userId)
 
 bool Query::updateUserProfileAvatarPath(unsigned int userId, const QString & avatarPath)
 {
-    prepare("UPDATE user_profile SET avatar_path = :avatarPath WHERE user_id = :userId");
+    prepareStatement(STATEMENT_UPDATE_USER_PROFILE_AVATAR_PATH,
+                     "UPDATE user_profile SET avatar_path = :avatarPath WHERE user_id = :userId");
     bindValue(":avatarPath", avatarPath);
     bindValue(":userId", userId);
     exec();
@@ -95,9 +150,20 @@ bool Query::updateUserProfileAvatarPath(unsigned int userId, const QString & ava
     return numRowsAffected() > 0 ? true : false;
 }
 
+bool Query::isAvatarPathInUse(const QString & avatarPath)
+{
+    prepareStatement(STATEMENT_IS_AVATAR_PATH_IN_USE,
+                     "SELECT 1 FROM user_profile WHERE avatar_path = :avatarPath LIMIT 1");
+    bindValue(":avatarPath", avatarPath);
+    exec();
+
+    return first();
+}
+
 bool Query::tournamentExists(const QString & tournamentName, unsigned int hostId)
 {
-    prepare("SELECT 1 FROM tournament WHERE name=:tournamentName AND host_user_id=:hostId");
+    prepareStatement(STATEMENT_TOURNAMENT_EXISTS,
+                     "SELECT 1 FROM tournament WHERE name=:tournamentName AND host_user_id=:hostId");
     bindValue(":tournamentName", tournamentName);
     bindValue(":hostId", hostId);
     exec();
@@ -107,8 +173,9 @@ bool Query::tournamentExists(const QString & tournamentName, unsigned int hostId
 
 bool Query::createTournament(const Tournament & tournament, unsigned int hostId, const QString & password)
 {
-    prepare("INSERT INTO tournament (name, host_user_id, password, entries_end_time, predictors_limit, opened) "
-                  "VALUES (:tournamentName, :hostId, :password, :entriesEndTime, :predictorsLimit, :opened)");
+    prepareStatement(STATEMENT_CREATE_TOURNAMENT,
+                     "INSERT INTO tournament (name, host_user_id, password, entries_end_time, predictors_limit, opened) "
+                     "VALUES (:tournamentName, :hostId, :password, :entriesEndTime, :predictorsLimit, :opened)");
     bindValue(":tournamentName", tournament.getName());
     bindValue(":hostId", hostId);
     bindValue(":password", password);
@@ -129,20 +196,21 @@ void Query::findTournaments(unsigned int hostId, const QDateTime & dateTime, int
     else
         tournamentNamePattern = QString("%" + tournamentName + "%").replace(' ', '%');
 
-    prepare("SELECT name, nickname as host_name, "
-            "(SELECT CASE WHEN length(tournament.password) = 0 THEN 0 ELSE 1 END) AS password_required, "
-            "entries_end_time, "
-            "(SELECT count(tournament_participant.id) FROM tournament_participant "
-            "INNER JOIN tournament AS t ON tournament_participant.tournament_id = tournament.id "
-            "WHERE t.id = tournament.id) as 'predictors', "
-            "predictors_limit FROM tournament "
-            "INNER JOIN user ON host_user_id = user.id "
-            "WHERE entries_end_time > :minDateTime AND tournament.id IN "
-            "(SELECT tournament_id FROM tournament_participant WHERE tournament_id NOT IN "
-            "(SELECT tournament_id FROM tournament_participant WHERE user_id = :hostId) "
-            "GROUP BY tournament_id) AND tournament.name LIKE :tournamentNamePattern "
-            "ORDER BY entries_end_time "
-            "LIMIT :itemsLimit");
+    prepareStatement(STATEMENT_FIND_TOURNAMENTS,
+                     "SELECT tournament.id, name, nickname as host_name, "
+                     "(SELECT CASE WHEN length(tournament.password) = 0 THEN 0 ELSE 1 END) AS password_required, "
+                     "entries_end_time, "
+                     "(SELECT count(tournament_participant.id) FROM tournament_participant "
+                     "INNER JOIN tournament AS t ON tournament_participant.tournament_id = tournament.id "
+                     "WHERE t.id = tournament.id) as 'predictors', "
+                     "predictors_limit FROM tournament "
+                     "INNER JOIN user ON host_user_id = user.id "
+                     "WHERE entries_end_time > :minDateTime AND tournament.id IN "
+                     "(SELECT tournament_id FROM tournament_participant WHERE tournament_id NOT IN "
+                     "(SELECT tournament_id FROM tournament_participant WHERE user_id = :hostId) "
+                     "GROUP BY tournament_id) AND tournament.name LIKE :tournamentNamePattern "
+                     "ORDER BY entries_end_time "
+                     "LIMIT :itemsLimit");
     bindValue(":hostId", hostId);
     bindValue(":minDateTime", dateTime);
     bindValue(":itemsLimit", itemsLimit);
@@ -152,7 +220,8 @@ void Query::findTournaments(unsigned int hostId, const QDateTime & dateTime, int
 
 bool Query::findTournamentId(const QString & tournamentName, unsigned int hostId)
 {
-    prepare("SELECT id FROM tournament WHERE name = :tournamentName AND host_user_id = :hostId");
+    prepareStatement(STATEMENT_FIND_TOURNAMENT_ID,
+                     "SELECT id FROM tournament WHERE name = :tournamentName AND host_user_id = :hostId");
     bindValue(":tournamentName", tournamentName);
     bindValue(":hostId", hostId);
     exec();
@@ -162,7 +231,8 @@ bool Query::findTournamentId(const QString & tournamentName, unsigned int hostId
 
 bool Query::tournamentIsOpened(unsigned int tournamentId)
 {
-    prepare("SELECT opened FROM tournament WHERE id = :tournamentId");
+    prepareStatement(STATEMENT_TOURNAMENT_IS_OPENED,
+                     "SELECT opened FROM tournament WHERE id = :tournamentId");
     bindValue(":tournamentId", tournamentId);
     exec();
     next();
@@ -170,10 +240,31 @@ bool Query::tournamentIsOpened(unsigned int tournamentId)
     return value("opened").toBool();
 }
 
+bool Query::roundExists(unsigned int roundId)
+{
+    prepareStatement(STATEMENT_ROUND_EXISTS, "SELECT 1 FROM round WHERE id = :roundId");
+    bindValue(":roundId", roundId);
+    exec();
+
+    return first();
+}
+
+bool Query::roundIsClosed(unsigned int roundId)
+{
+    prepareStatement(STATEMENT_ROUND_IS_CLOSED,
+                     "SELECT 1 FROM round INNER JOIN tournament ON tournament.id = round.tournament_id "
+                     "WHERE round.id = :roundId AND tournament.opened = 0");
+    bindValue(":roundId", roundId);
+    exec();
+
+    return first();
+}
+
 bool Query::tournamentEntriesExpired(unsigned int tournamentId)
 {
-    prepare("SELECT CASE WHEN datetime(entries_end_time) <= datetime('now', 'localtime') "
-            "THEN 1 ELSE 0 END as expired FROM tournament WHERE id = :tournamentId");
+    prepareStatement(STATEMENT_TOURNAMENT_ENTRIES_EXPIRED,
+                     "SELECT CASE WHEN datetime(entries_end_time) <= datetime('now', 'localtime') "
+                     "THEN 1 ELSE 0 END as expired FROM tournament WHERE id = :tournamentId");
     bindValue(":tournamentId", tournamentId);
     exec();
     next();
@@ -183,8 +274,9 @@ bool Query::tournamentEntriesExpired(unsigned int tournamentId)
 
 bool Query::userPatricipatesInTournament(unsigned int tournamentId, unsigned int userId)
 {
-    prepare("SELECT 1 FROM tournament_participant "
-            "WHERE tournament_id = :tournamentId AND user_id = :userId");
+    prepareStatement(STATEMENT_USER_PATRICIPATES_IN_TOURNAMENT,
+                     "SELECT 1 FROM tournament_participant "
+                     "WHERE tournament_id = :tournamentId AND user_id = :userId");
     bindValue(":tournamentId", tournamentId);
     bindValue(":userId", userId);
     exec();
@@ -194,8 +286,9 @@ bool Query::userPatricipatesInTournament(unsigned int tournamentId, unsigned int
 
 bool Query::tournamentRequiresPassword(unsigned int tournamentId)
 {
-    prepare("SELECT (SELECT CASE WHEN length(tournament.password) = 0 THEN 0 ELSE 1 END) "
-            "AS password_required FROM tournament WHERE id = :tournamentId");
+    prepareStatement(STATEMENT_TOURNAMENT_REQUIRES_PASSWORD,
+                     "SELECT (SELECT CASE WHEN length(tournament.password) = 0 THEN 0 ELSE 1 END) "
+                     "AS password_required FROM tournament WHERE id = :tournamentId");
     bindValue(":tournamentId", tournamentId);
     exec();
     next();
@@ -205,8 +298,9 @@ bool Query::tournamentRequiresPassword(unsigned int tournamentId)
 
 bool Query::tournamentPasswordIsCorrect(unsigned int tournamentId, const QString & password)
 {
-    prepare("SELECT CASE WHEN password = :password THEN 1 ELSE 0 END as password_ok FROM tournament "
-            "WHERE id = :tournamentId");
+    prepareStatement(STATEMENT_TOURNAMENT_PASSWORD_IS_CORRECT,
+                     "SELECT CASE WHEN password = :password THEN 1 ELSE 0 END as password_ok FROM tournament "
+                     "WHERE id = :tournamentId");
     bindValue(":tournamentId", tournamentId);
     bindValue(":password", password);
     exec();
@@ -217,9 +311,10 @@ bool Query::tournamentPasswordIsCorrect(unsigned int tournamentId, const QString
 
 bool Query::tournamentIsFull(unsigned int tournamentId)
 {
-    prepare("SELECT CASE WHEN (SELECT count(id) FROM tournament_participant WHERE "
-            "tournament_id = :tournamentId) < predictors_limit THEN 0 ELSE 1 END as is_full "
-            "FROM tournament WHERE id = :tournamentId");
+    prepareStatement(STATEMENT_TOURNAMENT_IS_FULL,
+                     "SELECT CASE WHEN (SELECT count(id) FROM tournament_participant WHERE "
+                     "tournament_id = :tournamentId) < predictors_limit THEN 0 ELSE 1 END as is_full "
+                     "FROM tournament WHERE id = :tournamentId");
     bindValue(":tournamentId", tournamentId);
     exec();
     next();
@@ -229,8 +324,9 @@ bool Query::tournamentIsFull(unsigned int tournamentId)
 
 bool Query::addUserToTournament(unsigned int tournamentId, unsigned int userId)
 {
-    prepare("INSERT INTO tournament_participant (tournament_id, user_id) "
-            "VALUES (:tournamentId, :userId)");
+    prepareStatement(STATEMENT_ADD_USER_TO_TOURNAMENT,
+                     "INSERT INTO tournament_participant (tournament_id, user_id) "
+                     "VALUES (:tournamentId, :userId)");
     bindValue(":tournamentId", tournamentId);
     bindValue(":userId", userId);
     exec();
@@ -240,31 +336,34 @@ bool Query::addUserToTournament(unsigned int tournamentId, unsigned int userId)
 
 void Query::findTournamentInfo(unsigned int tournamentId)
 {
-    prepare("SELECT (SELECT CASE WHEN length(password) > 0 THEN 1 ELSE 0 END "
-            "FROM tournament WHERE id = :tournamentId) AS password_required, entries_end_time, "
-            "(SELECT count(id) FROM tournament_participant WHERE tournament_id = :tournamentId) "
-            "AS predictors, predictors_limit, opened FROM tournament "
-            "INNER JOIN user ON tournament.host_user_id = user.id "
-            "WHERE tournament.id = :tournamentId");
+    prepareStatement(STATEMENT_FIND_TOURNAMENT_INFO,
+                     "SELECT (SELECT CASE WHEN length(password) > 0 THEN 1 ELSE 0 END "
+                     "FROM tournament WHERE id = :tournamentId) AS password_required, entries_end_time, "
+                     "(SELECT count(id) FROM tournament_participant WHERE tournament_id = :tournamentId) "
+                     "AS predictors, predictors_limit, opened FROM tournament "
+                     "INNER JOIN user ON tournament.host_user_id = user.id "
+                     "WHERE tournament.id = :tournamentId");
     bindValue(":tournamentId", tournamentId);
     exec();
 }
 
 void Query::findTournamentRounds(unsigned int tournamentId)
 {
-    prepare("SELECT name FROM round WHERE tournament_id = :tournamentId "
-            "ORDER BY number");
+    prepareStatement(STATEMENT_FIND_TOURNAMENT_ROUNDS,
+                     "SELECT id, name FROM round WHERE tournament_id = :tournamentId "
+                     "ORDER BY number");
     bindValue(":tournamentId", tournamentId);
     exec();
 }
 
 bool Query::allMatchesFinished(unsigned int tournamentId)
 {
-    prepare("SELECT CASE WHEN datetime( (SELECT predictions_end_time FROM match "
-            "INNER JOIN round ON round.id = match.round_id INNER JOIN tournament "
-            "ON tournament.id = round.tournament_id WHERE tournament_id = :tournamentId "
-            "ORDER BY predictions_end_time DESC LIMIT 1) ) >= datetime('now', 'localtime') "
-            "THEN 0 ELSE 1 END AS all_matches_finished");
+    prepareStatement(STATEMENT_ALL_MATCHES_FINISHED,
+                     "SELECT CASE WHEN datetime( (SELECT predictions_end_time FROM match "
+                     "INNER JOIN round ON round.id = match.round_id INNER JOIN tournament "
+                     "ON tournament.id = round.tournament_id WHERE tournament_id = :tournamentId "
+                     "ORDER BY predictions_end_time DESC LIMIT 1) ) >= datetime('now', 'localtime') "
+                     "THEN 0 ELSE 1 END AS all_matches_finished");
     bindValue(":tournamentId", tournamentId);
     exec();
     next();
@@ -274,7 +373,8 @@ bool Query::allMatchesFinished(unsigned int tournamentId)
 
 bool Query::finishTournament(unsigned int tournamentId)
 {
-    prepare("UPDATE tournament SET opened = 0 WHERE id = :tournamentId");
+    prepareStatement(STATEMENT_FINISH_TOURNAMENT,
+                     "UPDATE tournament SET opened = 0 WHERE id = :tournamentId");
     bindValue(":tournamentId", tournamentId);
     exec();
 
@@ -283,7 +383,8 @@ bool Query::finishTournament(unsigned int tournamentId)
 
 bool Query::duplicateNameOfRound(const QString & roundName, unsigned int tournamentId)
 {
-    prepare("SELECT 1 FROM round WHERE name = :roundName AND tournament_id = :tournamentId");
+    prepareStatement(STATEMENT_DUPLICATE_NAME_OF_ROUND,
+                     "SELECT 1 FROM round WHERE name = :roundName AND tournament_id = :tournamentId");
     bindValue(":roundName", roundName);
     bindValue(":tournamentId", tournamentId);
     exec();
@@ -293,9 +394,10 @@ bool Query::duplicateNameOfRound(const QString & roundName, unsigned int tournam
 
 bool Query::addNewRound(const QString & roundName, unsigned int tournamentId)
 {
-    prepare("INSERT INTO round (tournament_id, name, number) VALUES (:tournamentId, :roundName, "
-            "(SELECT CASE WHEN (SELECT count(id) FROM round WHERE tournament_id = :tournamentId) = 0 THEN 1 "
-            "ELSE (SELECT MAX(number) + 1 FROM round WHERE tournament_id = :tournamentId) END))");
+    prepareStatement(STATEMENT_ADD_NEW_ROUND,
+                     "INSERT INTO round (tournament_id, name, number) VALUES (:tournamentId, :roundName, "
+                     "(SELECT CASE WHEN (SELECT count(id) FROM round WHERE tournament_id = :tournamentId) = 0 THEN 1 "
+                     "ELSE (SELECT MAX(number) + 1 FROM round WHERE tournament_id = :tournamentId) END))");
     bindValue(":roundName", roundName);
     bindValue(":tournamentId", tournamentId);
     exec();
@@ -305,35 +407,24 @@ bool Query::addNewRound(const QString & roundName, unsigned int tournamentId)
 
 void Query::findTournamentLeaderboard(unsigned int tournamentId)
 {
-    prepare("SELECT nickname, exact_score, predicted_result, (exact_score * 3 + predicted_result - exact_score) "
-            "AS points FROM (SELECT DISTINCT user.nickname, (SELECT count(match_prediction.id) FROM match_prediction "
-            "INNER JOIN match ON match.id = match_prediction.match_id INNER JOIN tournament_participant ON "
-            "tournament_participant.id = match_prediction.tournament_participant_id INNER JOIN user u ON "
-            "u.id = tournament_participant.user_id WHERE tournament_participant.tournament_id = :tournamentId "
-            "AND u.id = user.id AND datetime(match.predictions_end_time) <= datetime('now', 'localtime') "
-            "AND (match_prediction.competitor_1_score_prediction = match.competitor_1_score AND "
-            "match_prediction.competitor_2_score_prediction = match.competitor_2_score) ) AS exact_score, "
-            "(SELECT count(match_prediction.id) FROM match_prediction INNER JOIN match ON "
-            "match.id = match_prediction.match_id INNER JOIN tournament_participant ON "
-            "tournament_participant.id = match_prediction.tournament_participant_id INNER JOIN user u ON "
-            "u.id = tournament_participant.user_id WHERE tournament_participant.tournament_id = :tournamentId "
-            "AND u.id = user.id AND datetime(match.predictions_end_time) <= datetime('now', 'localtime') AND "
-            "( (match.competitor_1_score > match.competitor_2_score AND "
-            "match_prediction.competitor_1_score_prediction > match_prediction.competitor_2_score_prediction) OR "
-            "(match.competitor_1_score < match.competitor_2_score AND "
-            "match_prediction.competitor_1_score_prediction < match_prediction.competitor_2_score_prediction) OR "
-            "(match.competitor_1_score = match.competitor_2_score AND "
-            "match_prediction.competitor_1_score_prediction = match_prediction.competitor_2_score_prediction) ) ) "
-            "AS predicted_result FROM user INNER JOIN tournament_participant ON "
-            "tournament_participant.user_id = user.id WHERE tournament_participant.tournament_id = :tournamentId) "
-            "ORDER BY points DESC, exact_score DESC, predicted_result DESC, nickname DESC");
+    prepareStatement(STATEMENT_FIND_TOURNAMENT_LEADERBOARD,
+                     "SELECT nickname, exact_score, predicted_result, (exact_score * 3 + predicted_result - exact_score) "
+                     "AS points FROM (SELECT user.nickname, "
+                     "ifnull(sum(round_participant_score.exact_score), 0) AS exact_score, "
+                     "ifnull(sum(round_participant_score.predicted_result), 0) AS predicted_result "
+                     "FROM tournament_participant INNER JOIN user ON user.id = tournament_participant.user_id "
+                     "LEFT JOIN round_participant_score ON "
+                     "round_participant_score.tournament_participant_id = tournament_participant.id "
+                     "WHERE tournament_participant.tournament_id = :tournamentId GROUP BY tournament_participant.id) "
+                     "ORDER BY points DESC, exact_score DESC, predicted_result DESC, nickname DESC");
     bindValue(":tournamentId", tournamentId);
     exec();
 }
 
 bool Query::findRoundId(const QString & roundName, unsigned int tournamentId)
 {
-    prepare("SELECT id FROM round WHERE name = :roundName AND tournament_id = :tournamentId");
+    prepareStatement(STATEMENT_FIND_ROUND_ID,
+                     "SELECT id FROM round WHERE name = :roundName AND tournament_id = :tournamentId");
     bindValue(":roundName", roundName);
     bindValue(":tournamentId", tournamentId);
     exec();
@@ -343,38 +434,115 @@ bool Query::findRoundId(const QString & roundName, unsigned int tournamentId)
 
 void Query::findRoundLeaderboard(unsigned int tournamentId, unsigned int roundId)
 {
-    prepare("SELECT nickname, exact_score, predicted_result, (exact_score * 3 + predicted_result - exact_score) "
-            "AS points FROM ( SELECT DISTINCT user.nickname, (SELECT count(match_prediction.id) FROM match_prediction "
-            "INNER JOIN match ON match.id = match_prediction.match_id INNER JOIN round ON round.id = match.round_id "
-            "INNER JOIN tournament_participant ON tournament_participant.id = match_prediction.tournament_participant_id "
-            "INNER JOIN user u ON u.id = tournament_participant.user_id WHERE round.id = :roundId1 AND u.id = user.id "
-            "AND datetime(match.predictions_end_time) <= datetime('now', 'localtime') AND "
-            "(match_prediction.competitor_1_score_prediction = match.competitor_1_score AND "
-            "match_prediction.competitor_2_score_prediction = match.competitor_2_score) ) AS exact_score, "
-            "(SELECT count(match_prediction.id) FROM match_prediction INNER JOIN match ON "
-            "match.id = match_prediction.match_id INNER JOIN round ON round.id = match.round_id INNER JOIN "
-            "tournament_participant ON tournament_participant.id = match_prediction.tournament_participant_id INNER JOIN "
-            "user u ON u.id = tournament_participant.user_id WHERE round.id = :roundId2 AND u.id = user.id AND "
-            "datetime(match.predictions_end_time) <= datetime('now', 'localtime') AND "
-            "( (match.competitor_1_score > match.competitor_2_score AND "
-            "match_prediction.competitor_1_score_prediction > match_prediction.competitor_2_score_prediction) OR "
-            "(match.competitor_1_score < match.competitor_2_score AND "
-            "match_prediction.competitor_1_score_prediction < match_prediction.competitor_2_score_prediction) OR "
-            "(match.competitor_1_score = match.competitor_2_score AND "
-            "match_prediction.competitor_1_score_prediction = match_prediction.competitor_2_score_prediction) )) "
-            "AS predicted_result FROM user INNER JOIN tournament_participant ON "
-            "tournament_participant.user_id = user.id WHERE tournament_participant.tournament_id = :tournamentId) "
-            "ORDER BY points DESC, exact_score DESC, predicted_result DESC, nickname DESC");
+    prepareStatement(STATEMENT_FIND_ROUND_LEADERBOARD,
+                     "SELECT nickname, exact_score, predicted_result, (exact_score * 3 + predicted_result - exact_score) "
+                     "AS points FROM (SELECT user.nickname, "
+                     "ifnull(round_participant_score.exact_score, 0) AS exact_score, "
+                     "ifnull(round_participant_score.predicted_result, 0) AS predicted_result "
+                     "FROM tournament_participant INNER JOIN user ON user.id = tournament_participant.user_id "
+                     "LEFT JOIN round_participant_score ON "
+                     "round_participant_score.tournament_participant_id = tournament_participant.id "
+                     "AND round_participant_score.round_id = :roundId "
+                     "WHERE tournament_participant.tournament_id = :tournamentId) "
+                     "ORDER BY points DESC, exact_score DESC, predicted_result DESC, nickname DESC");
     bindValue(":tournamentId", tournamentId);
-    bindValue(":roundId1", roundId);
-    bindValue(":roundId2", roundId);
+    bindValue(":roundId", roundId);
     exec();
 }
 
+void Query::findAllLeaderboardsEntries()
+{
+    prepareStatement(STATEMENT_FIND_ALL_LEADERBOARDS_ENTRIES,
+                     "SELECT tournament_participant.tournament_id, user.nickname, "
+                     "ifnull(sum(round_participant_score.exact_score), 0) AS exact_score, "
+                     "ifnull(sum(round_participant_score.predicted_result), 0) AS predicted_result "
+                     "FROM tournament_participant INNER JOIN user ON user.id = tournament_participant.user_id "
+                     "LEFT JOIN round_participant_score ON "
+                     "round_participant_score.tournament_participant_id = tournament_participant.id "
+                     "GROUP BY tournament_participant.id");
+    exec();
+}
+
+void Query::findAllSearchableTournaments()
+{
+    prepareStatement(STATEMENT_FIND_ALL_SEARCHABLE_TOURNAMENTS,
+                     "SELECT tournament.id, name, nickname AS host_name, "
+                     "(SELECT CASE WHEN length(tournament.password) = 0 THEN 0 ELSE 1 END) AS password_required, "
+                     "entries_end_time, predictors_limit FROM tournament "
+                     "INNER JOIN user ON host_user_id = user.id");
+    exec();
+}
+
+void Query::findAllTournamentsParticipants()
+{
+    prepareStatement(STATEMENT_FIND_ALL_TOURNAMENTS_PARTICIPANTS,
+                     "SELECT tournament_id, user_id FROM tournament_participant");
+    exec();
+}
+
+void Query::findUnsettledRounds()
+{
+    prepareStatement(STATEMENT_FIND_UNSETTLED_ROUNDS,
+                     "SELECT DISTINCT round.tournament_id, match.round_id FROM match "
+                     "INNER JOIN round ON round.id = match.round_id "
+                     "LEFT JOIN round_score_state ON round_score_state.round_id = match.round_id "
+                     "WHERE datetime(match.predictions_end_time) <= datetime('now', 'localtime') "
+                     "AND (round_score_state.settled_until IS NULL OR "
+                     "datetime(match.predictions_end_time) > datetime(round_score_state.settled_until))");
+    exec();
+}
+
+bool Query::refreshRoundScores(unsigned int roundId)
+{
+    QSqlDatabase database = dbConnection->getConnection();
+    QString now = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
+
+    if(!database.transaction())
+        return false;
+
+    prepareStatement(STATEMENT_DELETE_ROUND_SCORES,
+                     "DELETE FROM round_participant_score WHERE round_id = :roundId");
+    bindValue(":roundId", roundId);
+    bool refreshed = exec();
+
+    prepareStatement(STATEMENT_INSERT_ROUND_SCORES,
+                     "INSERT INTO round_participant_score (round_id, tournament_participant_id, exact_score, "
+                     "predicted_result) SELECT match.round_id, match_prediction.tournament_participant_id, "
+                     "sum(CASE WHEN match_prediction.competitor_1_score_prediction = match.competitor_1_score AND "
+                     "match_prediction.competitor_2_score_prediction = match.competitor_2_score THEN 1 ELSE 0 END), "
+                     "sum(CASE WHEN (match.competitor_1_score > match.competitor_2_score AND "
+                     "match_prediction.competitor_1_score_prediction > match_prediction.competitor_2_score_prediction) OR "
+                     "(match.competitor_1_score < match.competitor_2_score AND "
+                     "match_prediction.competitor_1_score_prediction < match_prediction.competitor_2_score_prediction) OR "
+                     "(match.competitor_1_score = match.competitor_2_score AND "
+                     "match_prediction.competitor_1_score_prediction = match_prediction.competitor_2_score_prediction) "
+                     "THEN 1 ELSE 0 END) FROM match_prediction INNER JOIN match ON match.id = match_prediction.match_id "
+                     "WHERE match.round_id = :roundId AND datetime(match.predictions_end_time) <= datetime(:now) "
+                     "GROUP BY match_prediction.tournament_participant_id");
+    bindValue(":roundId", roundId);
+    bindValue(":now", now);
+    refreshed = refreshed && exec();
+
+    prepareStatement(STATEMENT_UPDATE_ROUND_SCORE_STATE,
+                     "INSERT OR REPLACE INTO round_score_state (round_id, settled_until) VALUES (:roundId, :now)");
+    bindValue(":roundId", roundId);
+    bindValue(":now", now);
+    refreshed = refreshed && exec();
+
+    releaseStatement();
+
+    if(refreshed && database.commit())
+        return true;
+
+    database.rollback();
+    return false;
+}
+
 bool Query::matchStartsAfterEntriesEndTime(unsigned int tournamentId, const QDateTime & predictionsEndTime)
 {
-    prepare("SELECT CASE WHEN datetime(:predictionsEndTime) >= datetime(entries_end_time) THEN 1 ELSE 0 END AS "
-            "match_starts_after_entries_end_time FROM tournament WHERE id = :tournamentId");
+    prepareStatement(STATEMENT_MATCH_STARTS_AFTER_ENTRIES_END_TIME,
+                     "SELECT CASE WHEN datetime(:predictionsEndTime) >= datetime(entries_end_time) THEN 1 ELSE 0 END AS "
+                     "match_starts_after_entries_end_time FROM tournament WHERE id = :tournamentId");
     bindValue(":tournamentId", tournamentId);
     bindValue(":predictionsEndTime", predictionsEndTime);
     exec();
@@ -383,18 +551,25 @@ bool Query::matchStartsAfterEntriesEndTime(unsigned int tournamentId, const QDat
     return value("match_starts_after_entries_end_time").toBool();
 }
 
-void Query::findMatches(unsigned int roundId)
+void Query::findMatches(unsigned int roundId, const QString & lastEndTime, unsigned int lastMatchId, int limit)
 {
-    prepare("SELECT competitor_1, competitor_1_score, competitor_2, competitor_2_score, "
-            "predictions_end_time FROM match WHERE round_id = :roundId ORDER BY predictions_end_time");
+    prepareStatement(STATEMENT_FIND_MATCHES,
+                     "SELECT id, competitor_1, competitor_1_score, competitor_2, competitor_2_score, "
+                     "predictions_end_time FROM match WHERE round_id = :roundId AND "
+                     "(predictions_end_time, id) > (:lastEndTime, :lastMatchId) "
+                     "ORDER BY predictions_end_time, id LIMIT :limit");
     bindValue(":roundId", roundId);
+    bindValue(":lastEndTime", lastEndTime);
+    bindValue(":lastMatchId", lastMatchId);
+    bindValue(":limit", limit);
     exec();
 }
 
 bool Query::duplicateMatch(const QString & firstCompetitor, const QString & secondCompetitor, unsigned int roundId)
 {
-    prepare("SELECT 1 FROM match WHERE competitor_1 = :firstCompetitor AND competitor_2 = :secondCompetitor "
-            "AND round_id = :roundId");
+    prepareStatement(STATEMENT_DUPLICATE_MATCH,
+                     "SELECT 1 FROM match WHERE competitor_1 = :firstCompetitor AND competitor_2 = :secondCompetitor "
+                     "AND round_id = :roundId");
     bindValue(":firstCompetitor", firstCompetitor);
     bindValue(":secondCompetitor", secondCompetitor);
     bindValue(":roundId", roundId);
@@ -405,8 +580,9 @@ bool Query::duplicateMatch(const QString & firstCompetitor, const QString & seco
 
 bool Query::findMatchId(const QString & firstCompetitor, const QString & secondCompetitor, unsigned int roundId)
 {
-    prepare("SELECT id FROM match WHERE competitor_1 = :firstCompetitor "
-            "AND competitor_2 = :secondCompetitor AND round_id = :roundId");
+    prepareStatement(STATEMENT_FIND_MATCH_ID,
+                     "SELECT id FROM match WHERE competitor_1 = :firstCompetitor "
+                     "AND competitor_2 = :secondCompetitor AND round_id = :roundId");
     bindValue(":firstCompetitor", firstCompetitor);
     bindValue(":secondCompetitor", secondCompetitor);
     bindValue(":roundId", roundId);
@@ -418,8 +594,9 @@ bool Query::findMatchId(const QString & firstCompetitor, const QString & secondC
 bool Query::createMatch(unsigned int roundId, const QString & firstCompetitor, const QString & secondCompetitor,
                         const QDateTime & predictionsEndTime)
 {
-    prepare("INSERT INTO match (round_id, competitor_1, competitor_2, predictions_end_time) "
-            "VALUES (:roundId, :firstCompetitor, :secondCompetitor, :predictionsEndTime)");
+    prepareStatement(STATEMENT_CREATE_MATCH,
+                     "INSERT INTO match (round_id, competitor_1, competitor_2, predictions_end_time) "
+                     "VALUES (:roundId, :firstCompetitor, :secondCompetitor, :predictionsEndTime)");
     bindValue(":roundId", roundId);
     bindValue(":firstCompetitor", firstCompetitor);
     bindValue(":secondCompetitor", secondCompetitor);
@@ -431,8 +608,9 @@ bool Query::createMatch(unsigned int roundId, const QString & firstCompetitor, c
 
 bool Query::deleteMatch(unsigned int roundId, const QString & firstCompetitor, const QString & secondCompetitor)
 {
-    prepare("DELETE FROM match WHERE round_id = :roundId AND competitor_1 = :firstCompetitor AND "
-            "competitor_2 = :secondCompetitor");
+    prepareStatement(STATEMENT_DELETE_MATCH,
+                     "DELETE FROM match WHERE round_id = :roundId AND competitor_1 = :firstCompetitor AND "
+                     "competitor_2 = :secondCompetitor");
     bindValue(":roundId", roundId);
     bindValue(":firstCompetitor", firstCompetitor);
     bindValue(":secondCompetitor", secondCompetitor);
@@ -443,8 +621,9 @@ bool Query::deleteMatch(unsigned int roundId, const QString & firstCompetitor, c
 
 bool Query::updateMatchScore(unsigned int matchId, unsigned int firstCompetitorScore, unsigned int secondCompetitorScore)
 {
-    prepare("UPDATE match SET competitor_1_score = :firstCompetitorScore, "
-            "competitor_2_score = :secondCompetitorScore WHERE id = :matchId");
+    prepareStatement(STATEMENT_UPDATE_MATCH_SCORE,
+                     "UPDATE match SET competitor_1_score = :firstCompetitorScore, "
+                     "competitor_2_score = :secondCompetitorScore WHERE id = :matchId");
     bindValue(":firstCompetitorScore", firstCompetitorScore);
     bindValue(":secondCompetitorScore", secondCompetitorScore);
     bindValue(":matchId", matchId);
@@ -453,25 +632,49 @@ bool Query::updateMatchScore(unsigned int matchId, unsigned int firstCompetitorS
     return numRowsAffected() > 0 ? true : false;
 }
 
-void Query::findMatchesPredictions(unsigned int tournamentId, unsigned int roundId, unsigned int requesterId)
+bool Query::findMatchContext(unsigned int matchId)
 {
-    prepare("SELECT nickname, competitor_1_score_prediction, competitor_2_score_prediction, "
-            "competitor_1, competitor_2 FROM match_prediction INNER JOIN tournament_participant ON "
-            "match_prediction.tournament_participant_id = tournament_participant.id "
-            "INNER JOIN user ON tournament_participant.user_id = user.id "
-            "INNER JOIN match ON match_prediction.match_id = match.id "
-            "WHERE tournament_participant.tournament_id = :tournamentId AND match.round_id = :roundId "
-            "AND (datetime('now', 'localtime') >= datetime(predictions_end_time) OR user_id = :requesterId) "
-            "ORDER BY predictions_end_time");
+    prepareStatement(STATEMENT_FIND_MATCH_CONTEXT,
+                     "SELECT match.round_id, round.tournament_id, tournament.opened, user.nickname AS host_name, "
+                     "match.competitor_1, match.competitor_2 FROM match INNER JOIN round ON round.id = match.round_id "
+                     "INNER JOIN tournament ON tournament.id = round.tournament_id "
+                     "INNER JOIN user ON user.id = tournament.host_user_id WHERE match.id = :matchId");
+    bindValue(":matchId", matchId);
+    exec();
+
+    return first();
+}
+
+void Query::findMatchesPredictions(unsigned int tournamentId, unsigned int roundId, unsigned int requesterId,
+                                   const QString & lastEndTime, unsigned int lastMatchId, unsigned int lastPredictionId,
+                                   int limit)
+{
+    prepareStatement(STATEMENT_FIND_MATCHES_PREDICTIONS,
+                     "SELECT nickname, competitor_1_score_prediction, competitor_2_score_prediction, "
+                     "competitor_1, competitor_2, predictions_end_time, match.id AS match_id, "
+                     "match_prediction.id AS prediction_id FROM match_prediction INNER JOIN tournament_participant ON "
+                     "match_prediction.tournament_participant_id = tournament_participant.id "
+                     "INNER JOIN user ON tournament_participant.user_id = user.id "
+                     "INNER JOIN match ON match_prediction.match_id = match.id "
+                     "WHERE tournament_participant.tournament_id = :tournamentId AND match.round_id = :roundId "
+                     "AND (datetime('now', 'localtime') >= datetime(predictions_end_time) OR user_id = :requesterId) "
+                     "AND (predictions_end_time, match.id, match_prediction.id) > "
+                     "(:lastEndTime, :lastMatchId, :lastPredictionId) "
+                     "ORDER BY predictions_end_time, match.id, match_prediction.id LIMIT :limit");
     bindValue(":tournamentId", tournamentId);
     bindValue(":roundId", roundId);
     bindValue(":requesterId", requesterId);
+    bindValue(":lastEndTime", lastEndTime);
+    bindValue(":lastMatchId", lastMatchId);
+    bindValue(":lastPredictionId", lastPredictionId);
+    bindValue(":limit", limit);
     exec();
 }
 
 bool Query::findTournamentParticipantId(unsigned int userId, unsigned int tournamentId)
 {
-    prepare("SELECT id FROM tournament_participant WHERE user_id = :userId AND tournament_id = :tournamentId");
+    prepareStatement(STATEMENT_FIND_TOURNAMENT_PARTICIPANT_ID,
+                     "SELECT id FROM tournament_participant WHERE user_id = :userId AND tournament_id = :tournamentId");
     bindValue(":userId", userId);
     bindValue(":tournamentId", tournamentId);
     exec();
@@ -481,7 +684,8 @@ bool Query::findTournamentParticipantId(unsigned int userId, unsigned int tourna
 
 bool Query::matchPredictionAlreadyExists(unsigned int matchId, unsigned int participantId)
 {
-    prepare("SELECT 1 FROM match_prediction WHERE match_id = :matchId AND tournament_participant_id = :participantId");
+    prepareStatement(STATEMENT_MATCH_PREDICTION_ALREADY_EXISTS,
+                     "SELECT 1 FROM match_prediction WHERE match_id = :matchId AND tournament_participant_id = :participantId");
     bindValue(":matchId", matchId);
     bindValue(":participantId", participantId);
     exec();
@@ -491,8 +695,9 @@ bool Query::matchPredictionAlreadyExists(unsigned int matchId, unsigned int part
 
 bool Query::matchAcceptsPredictions(unsigned int matchId)
 {
-    prepare("SELECT CASE WHEN datetime(predictions_end_time) > datetime('now', 'localtime') THEN 1 ELSE 0 END "
-            "AS accepting_predictions FROM match WHERE id = :matchId");
+    prepareStatement(STATEMENT_MATCH_ACCEPTS_PREDICTIONS,
+                     "SELECT CASE WHEN datetime(predictions_end_time) > datetime('now', 'localtime') THEN 1 ELSE 0 END "
+                     "AS accepting_predictions FROM match WHERE id = :matchId");
     bindValue(":matchId", matchId);
     exec();
     next();
@@ -503,9 +708,10 @@ bool Query::matchAcceptsPredictions(unsigned int matchId)
 bool Query::createMatchPrediction(unsigned int matchId, unsigned int participantId,
                                   unsigned int firstCompetitorScore, unsigned int secondCompetitorScore)
 {
-    prepare("INSERT INTO match_prediction (match_id, tournament_participant_id, competitor_1_score_prediction, "
-            "competitor_2_score_prediction) VALUES (:matchId, :participantId, :firstCompetitorScore, "
-            ":secondCompetitorScore)");
+    prepareStatement(STATEMENT_CREATE_MATCH_PREDICTION,
+                     "INSERT INTO match_prediction (match_id, tournament_participant_id, competitor_1_score_prediction, "
+                     "competitor_2_score_prediction) VALUES (:matchId, :participantId, :firstCompetitorScore, "
+                     ":secondCompetitorScore)");
     bindValue(":matchId", matchId);
     bindValue(":participantId", participantId);
     bindValue(":firstCompetitorScore", firstCompetitorScore);
@@ -518,9 +724,10 @@ bool Query::createMatchPrediction(unsigned int matchId, unsigned int participant
 bool Query::updateMatchPrediction(unsigned int matchId, unsigned int participantId,
                                   unsigned int firstCompetitorScore, unsigned int secondCompetitorScore)
 {
-    prepare("UPDATE match_prediction SET competitor_1_score_prediction = :firstCompetitorScore, "
-            "competitor_2_score_prediction = :secondCompetitorScore "
-            "WHERE tournament_participant_id = :participantId AND match_id = :matchId");
+    prepareStatement(STATEMENT_UPDATE_MATCH_PREDICTION,
+                     "UPDATE match_prediction SET competitor_1_score_prediction = :firstCompetitorScore, "
+                     "competitor_2_score_prediction = :secondCompetitorScore "
+                     "WHERE tournament_participant_id = :participantId AND match_id = :matchId");
     bindValue(":matchId", matchId);
     bindValue(":participantId", participantId);
     bindValue(":firstCompetitorScore", firstCompetitorScore);
@@ -529,3 +736,52 @@ bool Query::updateMatchPrediction(unsigned int matchId, unsigned int participant
 
     return numRowsAffected() > 0 ? true : false;
 }
+
+bool Query::findPredictionContext(unsigned int matchId, const QString & nickname)
+{
+    prepareStatement(STATEMENT_FIND_PREDICTION_CONTEXT,
+                     "SELECT tournament.opened, match.competitor_1, match.competitor_2, "
+                     "CASE WHEN datetime(match.predictions_end_time) > datetime('now', 'localtime') THEN 1 ELSE 0 END "
+                     "AS accepting_predictions, tournament_participant.id AS participant_id, "
+                     "(SELECT count(match_prediction.id) FROM match_prediction WHERE match_prediction.match_id = match.id "
+                     "AND match_prediction.tournament_participant_id = tournament_participant.id) AS predictions_made "
+                     "FROM match INNER JOIN round ON round.id = match.round_id "
+                     "INNER JOIN tournament ON tournament.id = round.tournament_id "
+                     "LEFT JOIN user ON user.nickname = :nickname "
+                     "LEFT JOIN tournament_participant ON tournament_participant.tournament_id = tournament.id "
+                     "AND tournament_participant.user_id = user.id WHERE match.id = :matchId");
+    bindValue(":matchId", matchId);
+    bindValue(":nickname", nickname);
+    exec();
+
+    return first();
+}
+
+bool Query::prepareLeaderboardSchema()
+{
+    QSqlQuery schemaQuery(dbConnection->getConnection());
+    QStringList statements;
+
+    statements << "CREATE TABLE IF NOT EXISTS round_participant_score (round_id INTEGER NOT NULL "
+                  "REFERENCES round (id), tournament_participant_id INTEGER NOT NULL "
+                  "REFERENCES tournament_participant (id), exact_score INTEGER NOT NULL DEFAULT (0), "
+                  "predicted_result INTEGER NOT NULL DEFAULT (0), PRIMARY KEY (round_id, tournament_participant_id))"
+               << "CREATE INDEX IF NOT EXISTS round_participant_score_tournament_participant_id "
+                  "ON round_participant_score (tournament_participant_id)"
+               << "CREATE TABLE IF NOT EXISTS round_score_state (round_id INTEGER PRIMARY KEY NOT NULL "
+                  "REFERENCES round (id), settled_until DATETIME NOT NULL)"
+               << "CREATE TRIGGER IF NOT EXISTS delete_round_participant_score AFTER DELETE ON round "
+                  "FOR EACH ROW BEGIN DELETE FROM round_participant_score WHERE round_id = old.id; "
+                  "DELETE FROM round_score_state WHERE round_id = old.id; END"
+               << "CREATE TRIGGER IF NOT EXISTS delete_round_participant_score_after_tournament_participant_deletion "
+                  "AFTER DELETE ON tournament_participant FOR EACH ROW BEGIN DELETE FROM round_participant_score "
+                  "WHERE tournament_participant_id = old.id; END";
+
+    for(auto statement : statements)
+    {
+        if(!schemaQuery.exec(statement))
+            return false;
+    }
+
+    return true;
+}
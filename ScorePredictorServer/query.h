@@ -9,9 +9,81 @@
 
 class Query : public QSqlQuery
 {
+private:
+    enum Statement
+    {
+        NO_STATEMENT = -1,
+        STATEMENT_FIND_USER_ID,
+        STATEMENT_IS_USER_REGISTERED,
+        STATEMENT_REGISTER_USER,
+        STATEMENT_IS_PASSWORD_CORRECT,
+        STATEMENT_GET_USER_INFO,
+        STATEMENT_FIND_USER_TOURNAMENTS,
+        STATEMENT_UPDATE_USER_PROFILE_DESCRIPTION,
+        STATEMENT_FIND_USER_PROFILE_AVATAR_PATH,
+        STATEMENT_UPDATE_USER_PROFILE_AVATAR_PATH,
+        STATEMENT_IS_AVATAR_PATH_IN_USE,
+        STATEMENT_TOURNAMENT_EXISTS,
+        STATEMENT_CREATE_TOURNAMENT,
+        STATEMENT_FIND_TOURNAMENTS,
+        STATEMENT_FIND_TOURNAMENT_ID,
+        STATEMENT_TOURNAMENT_IS_OPENED,
+        STATEMENT_ROUND_EXISTS,
+        STATEMENT_ROUND_IS_CLOSED,
+        STATEMENT_TOURNAMENT_ENTRIES_EXPIRED,
+        STATEMENT_USER_PATRICIPATES_IN_TOURNAMENT,
+        STATEMENT_TOURNAMENT_REQUIRES_PASSWORD,
+        STATEMENT_TOURNAMENT_PASSWORD_IS_CORRECT,
+        STATEMENT_TOURNAMENT_IS_FULL,
+        STATEMENT_ADD_USER_TO_TOURNAMENT,
+        STATEMENT_FIND_TOURNAMENT_INFO,
+        STATEMENT_FIND_TOURNAMENT_ROUNDS,
+        STATEMENT_ALL_MATCHES_FINISHED,
+        STATEMENT_FINISH_TOURNAMENT,
+        STATEMENT_DUPLICATE_NAME_OF_ROUND,
+        STATEMENT_ADD_NEW_ROUND,
+        STATEMENT_FIND_TOURNAMENT_LEADERBOARD,
+        STATEMENT_FIND_ROUND_ID,
+        STATEMENT_FIND_ROUND_LEADERBOARD,
+        STATEMENT_MATCH_STARTS_AFTER_ENTRIES_END_TIME,
+        STATEMENT_FIND_MATCHES,
+        STATEMENT_DUPLICATE_MATCH,
+        STATEMENT_FIND_MATCH_ID,
+        STATEMENT_CREATE_MATCH,
+        STATEMENT_DELETE_MATCH,
+        STATEMENT_UPDATE_MATCH_SCORE,
+        STATEMENT_FIND_MATCHES_PREDICTIONS,
+        STATEMENT_FIND_TOURNAMENT_PARTICIPANT_ID,
+        STATEMENT_MATCH_PREDICTION_ALREADY_EXISTS,
+        STATEMENT_MATCH_ACCEPTS_PREDICTIONS,
+        STATEMENT_CREATE_MATCH_PREDICTION,
+        STATEMENT_UPDATE_MATCH_PREDICTION,
+        STATEMENT_FIND_MATCH_CONTEXT,
+        STATEMENT_FIND_PREDICTION_CONTEXT,
+        STATEMENT_FIND_UNSETTLED_ROUNDS,
+        STATEMENT_DELETE_ROUND_SCORES,
+        STATEMENT_INSERT_ROUND_SCORES,
+        STATEMENT_UPDATE_ROUND_SCORE_STATE,
+        STATEMENT_FIND_ALL_LEADERBOARDS_ENTRIES,
+        STATEMENT_FIND_ALL_SEARCHABLE_TOURNAMENTS,
+        STATEMENT_FIND_ALL_TOURNAMENTS_PARTICIPANTS
+    };
+
+    QSharedPointer<DbConnection> dbConnection;
+    Statement currentStatement;
+
+    void prepareStatement(Statement statement, const QString & sql);
+    void releaseStatement();
+
 public:
-    Query(const QSqlDatabase & dbConnection);
-    ~Query() {}
+    Query(QSharedPointer<DbConnection> connection);
+    ~Query();
+
+
+    using QSqlQuery::exec;
+    bool exec();
+
+    bool prepareLeaderboardSchema();
 
     bool findUserId(const QString & nickname);
     bool isUserRegistered(const QString & nickname);
@@ -24,6 +96,7 @@ public:
     bool updateUserProfileDescription(unsigned int userId, const QString & description);
     bool findUserProfileAvatarPath(unsigned int userId);
     bool updateUserProfileAvatarPath(unsigned int userId, const QString & avatarPath);
+    bool isAvatarPathInUse(const QString & avatarPath);
 
     bool tournamentExists(const QString & tournamentName, unsigned int hostId);
     bool createTournament(const Tournament & tournament, unsigned int hostId, const QString & password);
@@ -31,6 +104,8 @@ public:
     bool findTournamentId(const QString & tournamentName, unsigned int hostId);
 
     bool tournamentIsOpened(unsigned int tournamentId);
+    bool roundExists(unsigned int roundId);
+    bool roundIsClosed(unsigned int roundId);
     bool tournamentEntriesExpired(unsigned int tournamentId);
     bool userPatricipatesInTournament(unsigned int tournamentId, unsigned int userId);
     bool tournamentRequiresPassword(unsigned int tournamentId);
@@ -47,17 +122,25 @@ public:
     void findTournamentLeaderboard(unsigned int tournamentId);
     bool findRoundId(const QString & roundName, unsigned int tournamentId);
     void findRoundLeaderboard(unsigned int tournamentId, unsigned int roundId);
+    void findAllLeaderboardsEntries();
+    void findAllSearchableTournaments();
+    void findAllTournamentsParticipants();
+    void findUnsettledRounds();
+    bool refreshRoundScores(unsigned int roundId);
 
     bool matchStartsAfterEntriesEndTime(unsigned int tournamentId, const QDateTime & predictionsEndTime);
-    void findMatches(unsigned int roundId);
+    void findMatches(unsigned int roundId, const QString & lastEndTime, unsigned int lastMatchId, int limit);
     bool duplicateMatch(const QString & firstCompetitor, const QString & secondCompetitor, unsigned int roundId);
     bool findMatchId(const QString & firstCompetitor, const QString & secondCompetitor, unsigned int roundId);
     bool createMatch(unsigned int roundId, const QString & firstCompetitor, const QString & secondCompetitor,
                      const QDateTime & predictionsEndTime);
     bool deleteMatch(unsigned int roundId, const QString & firstCompetitor, const QString & secondCompetitor);
     bool updateMatchScore(unsigned int matchId, unsigned int firstCompetitorScore, unsigned int secondCompetitorScore);
+    bool findMatchContext(unsigned int matchId);
 
-    void findMatchesPredictions(unsigned int tournamentId, unsigned int roundId, unsigned int requesterId);
+    void findMatchesPredictions(unsigned int tournamentId, unsigned int roundId, unsigned int requesterId,
+                                const QString & lastEndTime, unsigned int lastMatchId, unsigned int lastPredictionId,
+                                int limit);
 
     bool findTournamentParticipantId(unsigned int userId, unsigned int tournamentId);
     bool matchPredictionAlreadyExists(unsigned int matchId, unsigned int participantId);
@@ -66,6 +149,7 @@ public:
                                unsigned int secondCompetitorScore);
     bool updateMatchPrediction(unsigned int matchId, unsigned int participantId, unsigned int firstCompetitorScore,
                                unsigned int secondCompetitorScore);
+    bool findPredictionContext(unsigned int matchId, const QString & nickname);
 };
 
 #endif // QUERY_H
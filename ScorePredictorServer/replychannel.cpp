@@ -0,0 +1,103 @@
+#include "replychannel.h"
+#include <tcpconnections.h>
+#include <servermetrics.h>
+
+ReplyChannel::ReplyChannel(TcpConnections * pool, quint64 id)
+{
+    connectionsPool = pool;
+    connectionId = id;
+    encoding = Packet::ENCODING_VARIANT;
+    queuedBytes = 0;
+    socketBytes = 0;
+    drainRequested = 0;
+}
+
+quint64 ReplyChannel::getConnectionId() const
+{
+    return connectionId;
+}
+
+QByteArray ReplyChannel::encode(const QVariantList & data) const
+{
+    qint64 encodeStartTime = ServerMetrics::now();
+    Packet packet(data, getEncoding());
+
+    if(packet.isCorrupted())
+        return QByteArray();
+
+    ServerMetrics::recordStage(data[0].toInt(), ServerMetrics::STAGE_ENCODE, encodeStartTime);
+
+    return packet.getSerializedData();
+}
+
+void ReplyChannel::send(const QVariantList & data)
+{
+    QByteArray frame = encode(data);
+
+    if(!frame.isEmpty())
+        sendFrame(data[0].toInt(), frame);
+}
+
+void ReplyChannel::sendFrame(int packetId, const QByteArray & frame)
+{
+    TcpConnections * pool = connectionsPool;
+    quint64 id = connectionId;
+    qint64 writeStartTime = ServerMetrics::now();
+
+    ServerMetrics::recordReply(packetId, frame.size());
+
+    // The write stage covers the hop to the socket thread as well as handing the frame to the socket.
+    queuedBytes.fetchAndAddOrdered(frame.size());
+    QMetaObject::invokeMethod(pool, [pool, id, frame, packetId, writeStartTime]() {
+        pool->deliverFrame(id, frame);
+        ServerMetrics::recordStage(packetId, ServerMetrics::STAGE_WRITE, writeStartTime);
+    }, Qt::QueuedConnection);
+}
+
+void ReplyChannel::finish()
+{
+    TcpConnections * pool = connectionsPool;
+    quint64 id = connectionId;
+
+    QMetaObject::invokeMethod(pool, [pool, id]() { pool->finishRequest(id); }, Qt::QueuedConnection);
+}
+
+Packet::Encoding ReplyChannel::getEncoding() const
+{
+    return Packet::Encoding(encoding.load());
+}
+
+void ReplyChannel::setEncoding(Packet::Encoding value)
+{
+    encoding.store(value);
+}
+
+qint64 ReplyChannel::pendingBytes() const
+{
+    return queuedBytes.load() + socketBytes.load();
+}
+
+void ReplyChannel::frameDelivered(int size)
+{
+    queuedBytes.fetchAndAddOrdered(-size);
+}
+
+void ReplyChannel::setSocketBytes(qint64 bytes)
+{
+    socketBytes.store(bytes);
+}
+
+bool ReplyChannel::isCongested() const
+{
+    return pendingBytes() > HIGH_WATER_MARK;
+}
+
+void ReplyChannel::requestDrainNotification()
+{
+    drainRequested.store(1);
+}
+
+bool ReplyChannel::takeDrainRequest()
+{
+    return drainRequested.testAndSetOrdered(1, 0);
+}
@@ -0,0 +1,46 @@
+#ifndef REPLYCHANNEL_H
+#define REPLYCHANNEL_H
+
+#include <QVariantList>
+#include <QAtomicInteger>
+#include <packet.h>
+
+class TcpConnections;
+
+class ReplyChannel
+{
+private:
+    TcpConnections * connectionsPool;
+    quint64 connectionId;
+    QAtomicInt encoding;
+    QAtomicInteger<qint64> queuedBytes;
+    QAtomicInteger<qint64> socketBytes;
+    QAtomicInt drainRequested;
+
+public:
+    ReplyChannel(TcpConnections * pool, quint64 id);
+    ~ReplyChannel() {}
+
+    quint64 getConnectionId() const;
+
+    QByteArray encode(const QVariantList & data) const;
+    void send(const QVariantList & data);
+    void sendFrame(int packetId, const QByteArray & frame);
+    void finish();
+
+    Packet::Encoding getEncoding() const;
+    void setEncoding(Packet::Encoding value);
+
+    qint64 pendingBytes() const;
+    void frameDelivered(int size);
+    void setSocketBytes(qint64 bytes);
+
+    bool isCongested() const;
+    void requestDrainNotification();
+    bool takeDrainRequest();
+
+    static const qint64 HIGH_WATER_MARK = 1024 * 1024;
+    static const qint64 LOW_WATER_MARK = 256 * 1024;
+};
+
+#endif // REPLYCHANNEL_H
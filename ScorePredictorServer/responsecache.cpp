@@ -0,0 +1,57 @@
+#include "responsecache.h"
+
+ResponseCache::ResponseCache()
+{
+    responses.setMaxCost(CACHE_CAPACITY);
+}
+
+unsigned int ResponseCache::getVersion(int packetId, unsigned int entityId) const
+{
+    QMutexLocker locker(&mutex);
+    return versions.value(qMakePair(packetId, entityId), 0);
+}
+
+bool ResponseCache::find(int packetId, unsigned int entityId, unsigned int version, Packet::Encoding encoding,
+                         QList<ResponseFrame> & frames)
+{
+    QMutexLocker locker(&mutex);
+    QList<ResponseFrame> * cachedFrames = responses.object(createKey(packetId, entityId, version, encoding));
+
+    if(!cachedFrames)
+        return false;
+
+    frames = *cachedFrames;
+    return true;
+}
+
+bool ResponseCache::insert(int packetId, unsigned int entityId, unsigned int version, Packet::Encoding encoding,
+                           const QList<ResponseFrame> & frames)
+{
+    int size = 0;
+
+    for(const ResponseFrame & frame : frames)
+        size += frame.data.size();
+
+    QMutexLocker locker(&mutex);
+
+    // The version was taken before the reply was built, a write that happened since then makes it stale.
+    if(versions.value(qMakePair(packetId, entityId), 0) != version)
+        return false;
+
+    return responses.insert(createKey(packetId, entityId, version, encoding), new QList<ResponseFrame>(frames), size);
+}
+
+void ResponseCache::invalidate(int packetId, unsigned int entityId)
+{
+    QMutexLocker locker(&mutex);
+    unsigned int & version = versions[qMakePair(packetId, entityId)];
+
+    responses.remove(createKey(packetId, entityId, version, Packet::ENCODING_VARIANT));
+    responses.remove(createKey(packetId, entityId, version, Packet::ENCODING_COMPACT));
+    version++;
+}
+
+QString ResponseCache::createKey(int packetId, unsigned int entityId, unsigned int version, Packet::Encoding encoding)
+{
+    return QString("%1:%2:%3:%4").arg(packetId).arg(entityId).arg(version).arg(int(encoding));
+}
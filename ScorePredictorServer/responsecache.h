@@ -0,0 +1,42 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <QByteArray>
+#include <packet.h>
+
+struct ResponseFrame
+{
+    int packetId;
+    QByteArray data;
+};
+
+class ResponseCache
+{
+private:
+    QCache<QString, QList<ResponseFrame> > responses;
+    QHash<QPair<int, unsigned int>, unsigned int> versions;
+    mutable QMutex mutex;
+
+    static const int CACHE_CAPACITY = 16 * 1024 * 1024;
+
+    static QString createKey(int packetId, unsigned int entityId, unsigned int version, Packet::Encoding encoding);
+
+public:
+    ResponseCache();
+    ~ResponseCache() {}
+
+    unsigned int getVersion(int packetId, unsigned int entityId) const;
+    bool find(int packetId, unsigned int entityId, unsigned int version, Packet::Encoding encoding,
+              QList<ResponseFrame> & frames);
+    bool insert(int packetId, unsigned int entityId, unsigned int version, Packet::Encoding encoding,
+                const QList<ResponseFrame> & frames);
+    void invalidate(int packetId, unsigned int entityId);
+
+    static const int MAX_RESPONSE_SIZE = 256 * 1024;
+};
+
+#endif // RESPONSECACHE_H
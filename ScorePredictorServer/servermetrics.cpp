@@ -0,0 +1,208 @@
+#include "servermetrics.h"
+#include <QElapsedTimer>
+
+ServerMetrics::PacketMetrics ServerMetrics::packets[ServerMetrics::NUMBER_OF_PACKET_IDS];
+
+namespace
+{
+    QElapsedTimer startClock()
+    {
+        QElapsedTimer clock;
+        clock.start();
+        return clock;
+    }
+}
+
+qint64 ServerMetrics::now()
+{
+    static const QElapsedTimer clock = startClock();
+    return clock.nsecsElapsed();
+}
+
+bool ServerMetrics::isValidPacketId(int packetId)
+{
+    return packetId >= 0 && packetId < NUMBER_OF_PACKET_IDS;
+}
+
+void ServerMetrics::recordRequest(int packetId, int bytes)
+{
+    if(!isValidPacketId(packetId))
+        return;
+
+    packets[packetId].requests.fetchAndAddRelaxed(1);
+    packets[packetId].bytesIn.fetchAndAddRelaxed(quint64(bytes));
+}
+
+void ServerMetrics::recordReply(int packetId, int bytes)
+{
+    if(isValidPacketId(packetId))
+        packets[packetId].bytesOut.fetchAndAddRelaxed(quint64(bytes));
+}
+
+void ServerMetrics::recordError(int packetId)
+{
+    if(isValidPacketId(packetId))
+        packets[packetId].errors.fetchAndAddRelaxed(1);
+}
+
+void ServerMetrics::recordStage(int packetId, Stage stage, qint64 startTime)
+{
+    if(isValidPacketId(packetId) && stage < NUMBER_OF_STAGES)
+        packets[packetId].stages[stage].record((now() - startTime) / 1000);
+}
+
+quint64 ServerMetrics::getRequests(int packetId)
+{
+    return isValidPacketId(packetId) ? packets[packetId].requests.load() : 0;
+}
+
+quint64 ServerMetrics::getErrors(int packetId)
+{
+    return isValidPacketId(packetId) ? packets[packetId].errors.load() : 0;
+}
+
+quint64 ServerMetrics::getBytesIn(int packetId)
+{
+    return isValidPacketId(packetId) ? packets[packetId].bytesIn.load() : 0;
+}
+
+quint64 ServerMetrics::getBytesOut(int packetId)
+{
+    return isValidPacketId(packetId) ? packets[packetId].bytesOut.load() : 0;
+}
+
+const LatencyHistogram * ServerMetrics::getHistogram(int packetId, Stage stage)
+{
+    if(!isValidPacketId(packetId) || stage >= NUMBER_OF_STAGES)
+        return nullptr;
+
+    return &packets[packetId].stages[stage];
+}
+
+bool ServerMetrics::isErrorReply(int packetId)
+{
+    switch(packetId)
+    {
+    case Packet::ID_ERROR:
+    case Packet::ID_UPDATE_USER_PROFILE_DESCRIPTION_ERROR:
+    case Packet::ID_UPDATE_USER_PROFILE_AVATAR_ERROR:
+    case Packet::ID_MATCH_DELETING_ERROR:
+    case Packet::ID_MATCH_SCORE_UPDATE_ERROR:
+    case Packet::ID_MAKE_PREDICTION_ERROR:
+    case Packet::ID_UPDATE_PREDICTION_ERROR:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+QString ServerMetrics::stageName(Stage stage)
+{
+    switch(stage)
+    {
+    case STAGE_DECODE: return QString("decode");
+    case STAGE_QUEUE: return QString("queue");
+    case STAGE_DATABASE: return QString("database");
+    case STAGE_ENCODE: return QString("encode");
+    case STAGE_WRITE: return QString("write");
+
+    default: return QString();
+    }
+}
+
+QString ServerMetrics::report()
+{
+    QString text;
+
+    for(int packetId=0; packetId<NUMBER_OF_PACKET_IDS; packetId++)
+    {
+        if(getRequests(packetId) == 0 && getBytesOut(packetId) == 0)
+            continue;
+
+        text += QString("Packet %1: %2 requests, %3 errors, %4 bytes in, %5 bytes out\n").arg(packetId)
+                .arg(getRequests(packetId)).arg(getErrors(packetId)).arg(getBytesIn(packetId))
+                .arg(getBytesOut(packetId));
+
+        for(int stage=0; stage<NUMBER_OF_STAGES; stage++)
+        {
+            const LatencyHistogram & histogram = packets[packetId].stages[stage];
+
+            if(histogram.getCount() == 0)
+                continue;
+
+            text += QString("    %1: %2 samples, p50 %3 us, p99 %4 us, p99.9 %5 us\n")
+                    .arg(stageName(Stage(stage))).arg(histogram.getCount()).arg(histogram.percentile(0.5))
+                    .arg(histogram.percentile(0.99)).arg(histogram.percentile(0.999));
+        }
+    }
+
+    return text;
+}
+
+void ServerMetrics::mergeStage(Stage stage, LatencyHistogram & histogram)
+{
+    if(stage >= NUMBER_OF_STAGES)
+        return;
+
+    for(int packetId=0; packetId<NUMBER_OF_PACKET_IDS; packetId++)
+        histogram.merge(packets[packetId].stages[stage]);
+}
+
+QString ServerMetrics::prometheusText()
+{
+    QString requests("# TYPE scorepredictor_packet_requests_total counter\n");
+    QString errors("# TYPE scorepredictor_packet_errors_total counter\n");
+    QString bytesIn("# TYPE scorepredictor_packet_bytes_in_total counter\n");
+    QString bytesOut("# TYPE scorepredictor_packet_bytes_out_total counter\n");
+    QString stages("# TYPE scorepredictor_packet_stage_seconds histogram\n");
+
+    for(int packetId=0; packetId<NUMBER_OF_PACKET_IDS; packetId++)
+    {
+        if(getRequests(packetId) == 0 && getBytesOut(packetId) == 0)
+            continue;
+
+        QString labels = QString("packet=\"%1\"").arg(packetId);
+        requests += QString("scorepredictor_packet_requests_total{%1} %2\n").arg(labels).arg(getRequests(packetId));
+        errors += QString("scorepredictor_packet_errors_total{%1} %2\n").arg(labels).arg(getErrors(packetId));
+        bytesIn += QString("scorepredictor_packet_bytes_in_total{%1} %2\n").arg(labels).arg(getBytesIn(packetId));
+        bytesOut += QString("scorepredictor_packet_bytes_out_total{%1} %2\n").arg(labels).arg(getBytesOut(packetId));
+
+        for(int stage=0; stage<NUMBER_OF_STAGES; stage++)
+        {
+            if(packets[packetId].stages[stage].getCount() > 0)
+                stages += prometheusHistogram("scorepredictor_packet_stage_seconds",
+                                              labels + QString(",stage=\"%1\"").arg(stageName(Stage(stage))),
+                                              packets[packetId].stages[stage]);
+        }
+    }
+
+    return requests + errors + bytesIn + bytesOut + stages;
+}
+
+QString ServerMetrics::prometheusHistogram(const QString & name, const QString & labels,
+                                           const LatencyHistogram & histogram)
+{
+    QString text;
+    quint64 cumulativeCount = 0;
+    int lastBucket = LatencyHistogram::BUCKET_COUNT - 1;
+
+    while(lastBucket > 0 && histogram.getBucketCount(lastBucket) == 0)
+        lastBucket--;
+
+    // Only the power of two boundaries are exported, the finer buckets are kept for percentiles.
+    for(int i=0; i<=lastBucket; i++)
+    {
+        cumulativeCount += histogram.getBucketCount(i);
+
+        if(i % LatencyHistogram::SUB_BUCKETS == LatencyHistogram::SUB_BUCKETS - 1 || i == lastBucket)
+            text += QString("%1_bucket{%2,le=\"%3\"} %4\n").arg(name).arg(labels)
+                    .arg(LatencyHistogram::bucketUpperBound(i) / 1000000.0, 0, 'g', 6).arg(cumulativeCount);
+    }
+
+    text += QString("%1_bucket{%2,le=\"+Inf\"} %3\n").arg(name).arg(labels).arg(cumulativeCount);
+    text += QString("%1_sum{%2} %3\n").arg(name).arg(labels).arg(histogram.getSum() / 1000000.0, 0, 'g', 9);
+    text += QString("%1_count{%2} %3\n").arg(name).arg(labels).arg(cumulativeCount);
+
+    return text;
+}
@@ -0,0 +1,61 @@
+#ifndef SERVERMETRICS_H
+#define SERVERMETRICS_H
+
+#include <QString>
+#include <QAtomicInteger>
+#include <packet.h>
+#include <latencyhistogram.h>
+
+class ServerMetrics
+{
+public:
+    enum Stage
+    {
+        STAGE_DECODE = 0,
+        STAGE_QUEUE,
+        STAGE_DATABASE,
+        STAGE_ENCODE,
+        STAGE_WRITE,
+        NUMBER_OF_STAGES
+    };
+
+    static const int NUMBER_OF_PACKET_IDS = Packet::ID_NEGOTIATE_ENCODING + 1;
+
+private:
+    struct PacketMetrics
+    {
+        QAtomicInteger<quint64> requests;
+        QAtomicInteger<quint64> errors;
+        QAtomicInteger<quint64> bytesIn;
+        QAtomicInteger<quint64> bytesOut;
+        LatencyHistogram stages[NUMBER_OF_STAGES];
+    };
+
+    static PacketMetrics packets[NUMBER_OF_PACKET_IDS];
+
+    static bool isValidPacketId(int packetId);
+    static QString prometheusHistogram(const QString & name, const QString & labels,
+                                       const LatencyHistogram & histogram);
+
+public:
+    static qint64 now();
+
+    static void recordRequest(int packetId, int bytes);
+    static void recordReply(int packetId, int bytes);
+    static void recordError(int packetId);
+    static void recordStage(int packetId, Stage stage, qint64 startTime);
+
+    static quint64 getRequests(int packetId);
+    static quint64 getErrors(int packetId);
+    static quint64 getBytesIn(int packetId);
+    static quint64 getBytesOut(int packetId);
+    static const LatencyHistogram * getHistogram(int packetId, Stage stage);
+
+    static bool isErrorReply(int packetId);
+    static QString stageName(Stage stage);
+    static QString report();
+    static QString prometheusText();
+    static void mergeStage(Stage stage, LatencyHistogram & histogram);
+};
+
+#endif // SERVERMETRICS_H
@@ -0,0 +1,63 @@
+#include "startingmessage.h"
+#include <QFile>
+#include <QTextStream>
+
+StartingMessage::StartingMessage(const QString & messagePath)
+{
+    path = messagePath;
+    loaded = false;
+
+    QVariantList responseData;
+    responseData << Packet::ID_ERROR << QString("Couldn't load starting message.");
+    setFrames(responseData);
+}
+
+bool StartingMessage::reload()
+{
+    QFile file(path);
+
+    // A message that was loaded once stays in place while the file is missing, e.g. in the middle of being replaced.
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QTextStream fileStream(&file);
+    fileStream.setCodec("UTF-8");
+
+    QVariantList responseData;
+    responseData << Packet::ID_DOWNLOAD_STARTING_MESSAGE << fileStream.readAll();
+    setFrames(responseData);
+
+    return true;
+}
+
+void StartingMessage::setFrames(const QVariantList & data)
+{
+    QByteArray variant = Packet(data, Packet::ENCODING_VARIANT).getSerializedData();
+    QByteArray compact = Packet(data, Packet::ENCODING_COMPACT).getSerializedData();
+
+    QWriteLocker locker(&lock);
+    variantFrame = variant;
+    compactFrame = compact;
+    loaded = data[0].toInt() == Packet::ID_DOWNLOAD_STARTING_MESSAGE;
+}
+
+bool StartingMessage::isLoaded() const
+{
+    QReadLocker locker(&lock);
+    return loaded;
+}
+
+QString StartingMessage::getPath() const
+{
+    return path;
+}
+
+QByteArray StartingMessage::getFrame(Packet::Encoding encoding) const
+{
+    QReadLocker locker(&lock);
+
+    if(encoding == Packet::ENCODING_COMPACT)
+        return compactFrame;
+
+    return variantFrame;
+}
@@ -0,0 +1,30 @@
+#ifndef STARTINGMESSAGE_H
+#define STARTINGMESSAGE_H
+
+#include <QReadWriteLock>
+#include <QByteArray>
+#include <QString>
+#include <packet.h>
+
+class StartingMessage
+{
+private:
+    QString path;
+    QByteArray variantFrame;
+    QByteArray compactFrame;
+    bool loaded;
+    mutable QReadWriteLock lock;
+
+    void setFrames(const QVariantList & data);
+
+public:
+    explicit StartingMessage(const QString & messagePath = QString("data/starting_message.txt"));
+    ~StartingMessage() {}
+
+    bool reload();
+    bool isLoaded() const;
+    QString getPath() const;
+    QByteArray getFrame(Packet::Encoding encoding) const;
+};
+
+#endif // STARTINGMESSAGE_H
@@ -2,7 +2,8 @@
 
 TcpConnection::TcpConnection(QObject * parent) : QObject(parent)
 {
-    nextPacketSize = 0;
+    flushScheduled = false;
+    readingPaused = false;
 }
 
 void TcpConnection::accept(qintptr descriptor)
@@ -11,6 +12,7 @@ void TcpConnection::accept(qintptr descriptor)
     connect(socket, &QTcpSocket::connected, this, &TcpConnection::connected);
     connect(socket, &QTcpSocket::disconnected, this, &TcpConnection::disconnected);
     connect(socket, &QTcpSocket::readyRead, this, &TcpConnection::read);
+    connect(socket, &QTcpSocket::bytesWritten, this, &TcpConnection::bytesWritten);
     connect(socket, &QTcpSocket::stateChanged, this, &TcpConnection::stateChanged);
     connect(socket, static_cast<void (QTcpSocket::*) (QAbstractSocket::SocketError)>(&QTcpSocket::error),
             this, &TcpConnection::error);
@@ -18,11 +20,16 @@ void TcpConnection::accept(qintptr descriptor)
     if(!socket->setSocketDescriptor(descriptor))
         return;
 
+    // read() drains the socket right away, the bound only matters while reading is paused: the socket then stops
+    // taking data from the kernel and TCP flow control slows the client down instead of server memory growing.
+    socket->setReadBufferSize(READ_BUFFER_SIZE);
+
     emit started();
 }
 
 void TcpConnection::quit()
 {
+    flush();
     socket->disconnectFromHost();
 }
 
@@ -38,41 +45,181 @@ void TcpConnection::disconnected()
 
 void TcpConnection::read()
 {
-    QDataStream in(socket);
-    in.setVersion(QDataStream::Qt_5_10);
+    busyTimer.start();
+    Packet packet;
 
-    if(nextPacketSize == 0)
+    do
     {
-        if(socket->bytesAvailable() < sizeof(quint16))
-            return;
+        qint64 decodeStartTime = ServerMetrics::now();
+
+        while(!readingPaused && readBuffer.takePacket(packet))
+        {
+            if(packet.isCorrupted())
+                continue;
+
+            int packetId = packet.getUnserializedData()[0].toInt();
+            ServerMetrics::recordRequest(packetId, readBuffer.getLastFrameSize());
+            ServerMetrics::recordStage(packetId, ServerMetrics::STAGE_DECODE, decodeStartTime);
+
+            if(packetId == Packet::ID_NEGOTIATE_ENCODING)
+                negotiateEncoding(packet.getUnserializedData());
+            else if(packetId == Packet::ID_DOWNLOAD_STARTING_MESSAGE && startingMessage)
+                sendStartingMessage();
+            else
+                emit packetArrived(packet);
+
+            decodeStartTime = ServerMetrics::now();
+        }
+    } while(!readingPaused && readBuffer.readFrom(socket) > 0);
 
-        in >> nextPacketSize;
+    if(readBuffer.hasOverflowed())
+    {
+        readBuffer.clear();
+        flushSocket();
     }
 
-    if(socket->bytesAvailable() < nextPacketSize)
+    if(load)
+        load->addBusyTime(busyTimer.nsecsElapsed());
+}
+
+void TcpConnection::send(const QVariantList & data)
+{
+    if(socket->state() != QTcpSocket::ConnectedState)
         return;
 
-    Packet packet(in);
+    qint64 encodeStartTime = ServerMetrics::now();
+    Packet packet(data, replyChannel->getEncoding());
+
     if(packet.isCorrupted())
-        flushSocket();
+        return;
+
+    ServerMetrics::recordStage(data[0].toInt(), ServerMetrics::STAGE_ENCODE, encodeStartTime);
+    ServerMetrics::recordReply(data[0].toInt(), packet.getSerializedData().size());
+    appendFrame(packet.getSerializedData());
+}
+
+void TcpConnection::sendFrame(const QByteArray & frame)
+{
+    busyTimer.start();
+    replyChannel->frameDelivered(frame.size());
+
+    if(socket->state() == QTcpSocket::ConnectedState)
+        appendFrame(frame);
     else
-        emit packetArrived(packet);
+        updatePendingBytes();
 
-    nextPacketSize = 0;
+    if(load)
+        load->addBusyTime(busyTimer.nsecsElapsed());
+}
+
+void TcpConnection::appendFrame(const QByteArray & frame)
+{
+    writeBuffer.append(frame);
 
-    if(socket->bytesAvailable() >= sizeof(quint16))
-        read();
+    if(writeBuffer.size() >= COALESCING_LIMIT)
+        flush();
+    else if(!flushScheduled)
+    {
+        flushScheduled = true;
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+
+    updatePendingBytes();
 }
 
-void TcpConnection::send(const QVariantList & data)
+void TcpConnection::flush()
+{
+    flushScheduled = false;
+
+    if(writeBuffer.isEmpty() || socket->state() != QTcpSocket::ConnectedState)
+        return;
+
+    socket->write(writeBuffer);
+    writeBuffer.clear();
+}
+
+void TcpConnection::bytesWritten(qint64 bytes)
+{
+    Q_UNUSED(bytes)
+    updatePendingBytes();
+}
+
+void TcpConnection::updatePendingBytes()
+{
+    replyChannel->setSocketBytes(writeBuffer.size() + socket->bytesToWrite());
+
+    if(replyChannel->pendingBytes() <= ReplyChannel::LOW_WATER_MARK && replyChannel->takeDrainRequest())
+        emit drained();
+}
+
+void TcpConnection::setReplyChannel(QSharedPointer<ReplyChannel> channel)
+{
+    replyChannel = channel;
+}
+
+void TcpConnection::setStartingMessage(QSharedPointer<StartingMessage> message)
+{
+    startingMessage = message;
+}
+
+QSharedPointer<ReplyChannel> TcpConnection::getReplyChannel() const
+{
+    return replyChannel;
+}
+
+quint64 TcpConnection::getConnectionId() const
+{
+    return replyChannel->getConnectionId();
+}
+
+void TcpConnection::setLoad(QSharedPointer<ConnectionsLoad> connectionsLoad)
+{
+    load = connectionsLoad;
+}
+
+void TcpConnection::setReadingPaused(bool paused)
+{
+    if(readingPaused == paused)
+        return;
+
+    readingPaused = paused;
+
+    if(!readingPaused)
+        QMetaObject::invokeMethod(this, "read", Qt::QueuedConnection);
+}
+
+bool TcpConnection::isReadingPaused() const
+{
+    return readingPaused;
+}
+
+void TcpConnection::negotiateEncoding(const QVariantList & data)
+{
+    int requestedEncoding = data.value(1).toInt();
+
+    if(requestedEncoding == Packet::ENCODING_COMPACT)
+        replyChannel->setEncoding(Packet::ENCODING_COMPACT);
+    else
+        replyChannel->setEncoding(Packet::ENCODING_VARIANT);
+
+    QVariantList responseData;
+    responseData << Packet::ID_NEGOTIATE_ENCODING << int(replyChannel->getEncoding());
+    send(responseData);
+}
+
+void TcpConnection::sendStartingMessage()
 {
     if(socket->state() != QTcpSocket::ConnectedState)
         return;
 
-    Packet packet(data);
+    // Every client asks for it right after connecting, so it is answered here from a frame encoded once.
+    QByteArray frame = startingMessage->getFrame(replyChannel->getEncoding());
+
+    if(!startingMessage->isLoaded())
+        ServerMetrics::recordError(Packet::ID_DOWNLOAD_STARTING_MESSAGE);
 
-    if(!packet.isCorrupted())
-        socket->write(packet.getSerializedData());
+    ServerMetrics::recordReply(Packet::ID_DOWNLOAD_STARTING_MESSAGE, frame.size());
+    appendFrame(frame);
 }
 
 void TcpConnection::flushSocket()
@@ -3,6 +3,13 @@
 
 #include <QTcpSocket>
 #include <packet.h>
+#include <packetbuffer.h>
+#include <replychannel.h>
+#include <connectionsload.h>
+#include <servermetrics.h>
+#include <startingmessage.h>
+#include <QSharedPointer>
+#include <QElapsedTimer>
 
 class TcpConnection : public QObject
 {
@@ -10,12 +17,28 @@ class TcpConnection : public QObject
 
 private:
     QTcpSocket * socket;
-    quint16 nextPacketSize;
+    PacketBuffer readBuffer;
+    QByteArray writeBuffer;
+    QSharedPointer<ReplyChannel> replyChannel;
+    QSharedPointer<ConnectionsLoad> load;
+    QSharedPointer<StartingMessage> startingMessage;
+    QElapsedTimer busyTimer;
+    bool flushScheduled;
+    bool readingPaused;
+
+    static const int COALESCING_LIMIT = 64 * 1024;
+    static const int READ_BUFFER_SIZE = 64 * 1024;
 
     void flushSocket();
+    void negotiateEncoding(const QVariantList & data);
+    void sendStartingMessage();
+    void appendFrame(const QByteArray & frame);
+    void updatePendingBytes();
 
 private slots:
     void read();
+    void flush();
+    void bytesWritten(qint64 bytes);
     void stateChanged(QAbstractSocket::SocketState state);
     void error(QAbstractSocket::SocketError error);
     void connected();
@@ -25,15 +48,26 @@ public:
     explicit TcpConnection(QObject * parent = nullptr);
     ~TcpConnection() {}
 
+    void setReplyChannel(QSharedPointer<ReplyChannel> channel);
+    QSharedPointer<ReplyChannel> getReplyChannel() const;
+    quint64 getConnectionId() const;
+    void setLoad(QSharedPointer<ConnectionsLoad> connectionsLoad);
+    void setStartingMessage(QSharedPointer<StartingMessage> message);
+
+    void setReadingPaused(bool paused);
+    bool isReadingPaused() const;
+
 public slots:
     void accept(qintptr descriptor);
     void quit();
     void send(const QVariantList & data);
+    void sendFrame(const QByteArray & frame);
 
 signals:
     void started();
     void finished();
     void packetArrived(const Packet & packet);
+    void drained();
 };
 
 #endif // TCPCONNECTION_H
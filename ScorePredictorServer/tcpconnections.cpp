@@ -1,22 +1,19 @@
 #include "tcpconnections.h"
 
-QMutex TcpConnections::mutex;
+QAtomicInteger<quint64> TcpConnections::nextConnectionId(1);
 
-TcpConnections::TcpConnections(QObject * parent) : QObject(parent)
+TcpConnections::TcpConnections(QSharedPointer<ConnectionsLoad> connectionsLoad, DbWorkerPool * workers,
+                               QSharedPointer<StartingMessage> message, QObject * parent) : QObject(parent)
 {
-
-}
-
-void TcpConnections::init()
-{
-    if(dbConnection)
-        return;
-
-    QMutexLocker locker(&mutex);
-
-    dbConnection = QSharedPointer<DbConnection>(new DbConnection(this));
-    dbConnection->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE=1;QSQLITE_BUSY_TIMEOUT=10000;");
-    dbConnection->connect(QString::number(dbConnection->numberOfOpenedConnections()));
+    workerPool = workers;
+    load = connectionsLoad;
+    startingMessage = message;
+    acceptor = nullptr;
+
+    loadTimer = new QTimer(this);
+    loadTimer->setInterval(LOAD_SAMPLE_INTERVAL);
+    connect(loadTimer, &QTimer::timeout, this, &TcpConnections::publishLoad);
+    loadTimer->start();
 }
 
 void TcpConnections::connectionStarted()
@@ -34,9 +31,18 @@ void TcpConnections::connectionFinished()
     if(!connection)
         return;
 
-    connections.removeAll(connection);
+    quint64 connectionId = connection->getConnectionId();
+    connections.remove(connectionId);
     connection->deleteLater();
 
+    if(connection->isReadingPaused())
+        load->requestFinished();
+
+    load->connectionClosed();
+
+    if(workerPool)
+        workerPool->connectionClosed(connectionId);
+
     emit connectionsDecreased();
 }
 
@@ -50,26 +56,62 @@ void TcpConnections::connectionPending(qintptr descriptor)
     emit connectionsIncreased();
 }
 
+void TcpConnections::connectionAccepted(qintptr descriptor)
+{
+    // The shared acceptor bypasses TcpServer, so the connection is counted here instead of at placement.
+    load->connectionAccepted();
+    connectionPending(descriptor);
+}
+
+void TcpConnections::listenShared(const QHostAddress & address, quint16 port)
+{
+    if(acceptor)
+        return;
+
+    acceptor = new PoolAcceptor(this);
+    connect(acceptor, &PoolAcceptor::connectionAccepted, this, &TcpConnections::connectionAccepted);
+
+    if(!acceptor->listenShared(address, port))
+    {
+        qWarning("Couldn't open a shared listening socket on port %d.", port);
+        acceptor->deleteLater();
+        acceptor = nullptr;
+    }
+}
+
+void TcpConnections::publishLoad()
+{
+    load->publishBusyTime(LOAD_SAMPLE_INTERVAL);
+}
+
 void TcpConnections::close()
 {
-    QMutexLocker locker(&mutex);
-    dbConnection->close();
+    if(acceptor)
+        acceptor->close();
 
     for(auto connection : connections)
-        connection->quit();
+    {
+        if(connection)
+            connection->quit();
+    }
 
     emit finished();
 }
 
 QPointer<TcpConnection> TcpConnections::createConnection(qintptr descriptor)
 {
+    quint64 connectionId = nextConnectionId.fetchAndAddRelaxed(1);
     QPointer<TcpConnection> connection = new TcpConnection(this);
+    connection->setReplyChannel(QSharedPointer<ReplyChannel>(new ReplyChannel(this, connectionId)));
+    connection->setLoad(load);
+    connection->setStartingMessage(startingMessage);
 
     connect(connection, &TcpConnection::started, this, &TcpConnections::connectionStarted);
     connect(connection, &TcpConnection::finished, this, &TcpConnections::connectionFinished);
     connect(connection, &TcpConnection::packetArrived, this, &TcpConnections::processPacket);
+    connect(connection, &TcpConnection::drained, this, &TcpConnections::connectionDrained);
 
-    connections.append(connection);
+    connections.insert(connectionId, connection);
     connection->accept(descriptor);
 
     return connection;
@@ -77,10 +119,52 @@ QPointer<TcpConnection> TcpConnections::createConnection(qintptr descriptor)
 
 void TcpConnections::processPacket(const Packet & packet)
 {
-    QPointer<TcpConnection> connection = qobject_cast<TcpConnection *>(sender());
-    Server::PacketProcessor * packetProcessor = new Server::PacketProcessor(dbConnection, this);
-    connect(packetProcessor, &Server::PacketProcessor::response, connection, &TcpConnection::send);
+    TcpConnection * connection = qobject_cast<TcpConnection *>(sender());
+
+    if(!connection || !workerPool)
+        return;
+
+    // Requests of one connection are handled one at a time, so its replies keep their order.
+    connection->setReadingPaused(true);
+
+    if(workerPool->submit(packet, connection->getReplyChannel()))
+        load->requestStarted();
+    else
+    {
+        QVariantList responseData;
+        responseData << Packet::ID_ERROR << QString("The server is busy. Try again later.");
+        connection->send(responseData);
+        connection->setReadingPaused(false);
+    }
+}
+
+void TcpConnections::connectionDrained()
+{
+    TcpConnection * connection = qobject_cast<TcpConnection *>(sender());
+
+    if(!connection || !workerPool)
+        return;
+
+    workerPool->connectionDrained(connection->getConnectionId());
+}
+
+void TcpConnections::deliverFrame(quint64 connectionId, const QByteArray & frame)
+{
+    QPointer<TcpConnection> connection = connections.value(connectionId);
+
+    if(connection)
+        connection->sendFrame(frame);
+}
+
+void TcpConnections::finishRequest(quint64 connectionId)
+{
+    QPointer<TcpConnection> connection = connections.value(connectionId);
+
+    if(!connection)
+        return;
+
+    if(connection->isReadingPaused())
+        load->requestFinished();
 
-    packetProcessor->processPacket(packet);
-    packetProcessor->deleteLater();
+    connection->setReadingPaused(false);
 }
@@ -3,13 +3,17 @@
 
 #include <QObject>
 #include <QSharedPointer>
-#include <QMutex>
-#include <QMutexLocker>
+#include <QHash>
 #include <QPointer>
+#include <QAtomicInteger>
+#include <QTimer>
 #include <tcpconnection.h>
-#include <dbconnection.h>
+#include <connectionsload.h>
+#include <startingmessage.h>
+#include <poolacceptor.h>
+#include <replychannel.h>
+#include <dbworkerpool.h>
 #include <packet.h>
-#include <packetprocessor.h>
 
 
 class TcpConnections : public QObject
@@ -17,27 +21,41 @@ class TcpConnections : public QObject
     Q_OBJECT
 
 private:
-    QList<QPointer<TcpConnection> > connections;
-    QSharedPointer<DbConnection> dbConnection;
-    static QMutex mutex;
+    QHash<quint64, QPointer<TcpConnection> > connections;
+    DbWorkerPool * workerPool;
+    QSharedPointer<ConnectionsLoad> load;
+    QSharedPointer<StartingMessage> startingMessage;
+    QTimer * loadTimer;
+    PoolAcceptor * acceptor;
+    static QAtomicInteger<quint64> nextConnectionId;
+
+    static const int LOAD_SAMPLE_INTERVAL = 1000;
 
     QPointer<TcpConnection> createConnection(qintptr descriptor);
 
 private slots:
     void processPacket(const Packet & packet);
+    void connectionDrained();
+    void connectionAccepted(qintptr descriptor);
+    void publishLoad();
 
 public:
-    explicit TcpConnections(QObject * parent = nullptr);
+    explicit TcpConnections(QSharedPointer<ConnectionsLoad> connectionsLoad, DbWorkerPool * workers = nullptr,
+                            QSharedPointer<StartingMessage> message = QSharedPointer<StartingMessage>(),
+                            QObject * parent = nullptr);
     ~TcpConnections() {}
 
+    void listenShared(const QHostAddress & address, quint16 port);
+
+    void deliverFrame(quint64 connectionId, const QByteArray & frame);
+    void finishRequest(quint64 connectionId);
+
 public slots:
     void connectionPending(qintptr descriptor);
     void connectionStarted();
     void connectionFinished();
     void close();
 
-    void init();
-
 signals:
     void finished();
     void connectionsIncreased();
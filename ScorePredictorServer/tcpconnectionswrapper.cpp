@@ -1,10 +1,12 @@
 #include "tcpconnectionswrapper.h"
 
-TcpConnectionsWrapper::TcpConnectionsWrapper(QObject * parent) : QObject(parent)
+TcpConnectionsWrapper::TcpConnectionsWrapper(DbWorkerPool * workers, QSharedPointer<StartingMessage> startingMessage,
+                                             QObject * parent) : QObject(parent)
 {
     workerThread = new QThread(this);
     numberOfConnections = 0;
-    connectionPool = new TcpConnections();
+    load = QSharedPointer<ConnectionsLoad>(new ConnectionsLoad());
+    connectionPool = new TcpConnections(load, workers, startingMessage);
 
     connect(this, &TcpConnectionsWrapper::pendingConnection, connectionPool,
             &TcpConnections::connectionPending, Qt::QueuedConnection);
@@ -16,7 +18,6 @@ TcpConnectionsWrapper::TcpConnectionsWrapper(QObject * parent) : QObject(parent)
             &TcpConnections::close, Qt::QueuedConnection);
     connect(connectionPool, &TcpConnections::finished, this,
             &TcpConnectionsWrapper::terminate, Qt::QueuedConnection);
-    connect(workerThread, &QThread::started, connectionPool, &TcpConnections::init);
 
     workerThread->start();
     connectionPool->moveToThread(workerThread);
@@ -64,3 +65,15 @@ int TcpConnectionsWrapper::getNumberOfConnections() const
 {
     return numberOfConnections;
 }
+
+QSharedPointer<ConnectionsLoad> TcpConnectionsWrapper::getLoad() const
+{
+    return load;
+}
+
+void TcpConnectionsWrapper::listenShared(const QHostAddress & address, quint16 port)
+{
+    TcpConnections * pool = connectionPool;
+    QMetaObject::invokeMethod(pool, [pool, address, port]() { pool->listenShared(address, port); },
+                              Qt::QueuedConnection);
+}
@@ -12,6 +12,7 @@ class TcpConnectionsWrapper : public QObject
 private:
     QThread * workerThread;
     TcpConnections * connectionPool;
+    QSharedPointer<ConnectionsLoad> load;
     int numberOfConnections;
 
 private slots:
@@ -20,10 +21,14 @@ private slots:
     void terminate();
 
 public:
-    explicit TcpConnectionsWrapper(QObject * parent = nullptr);
+    explicit TcpConnectionsWrapper(DbWorkerPool * workers = nullptr,
+                                   QSharedPointer<StartingMessage> startingMessage = QSharedPointer<StartingMessage>(),
+                                   QObject * parent = nullptr);
     ~TcpConnectionsWrapper();
 
     int getNumberOfConnections() const;
+    QSharedPointer<ConnectionsLoad> getLoad() const;
+    void listenShared(const QHostAddress & address, quint16 port);
 
 public slots:
     void close();
@@ -2,17 +2,56 @@
 
 TcpServer::TcpServer(QObject * parent) : QTcpServer(parent)
 {
-    QThreadPool::globalInstance()->setMaxThreadCount(QThread::idealThreadCount());
+    numberOfConnectionPools = QThread::idealThreadCount();
+    numberOfDbWorkers = QThread::idealThreadCount();
+    sharedAccept = false;
+    leaderboards = QSharedPointer<LeaderboardEngine>(new LeaderboardEngine());
+    tournamentSearch = QSharedPointer<TournamentSearchIndex>(new TournamentSearchIndex());
+    avatars = QSharedPointer<AvatarStore>(new AvatarStore());
+    responses = QSharedPointer<ResponseCache>(new ResponseCache());
+    workerPool = new DbWorkerPool(leaderboards, tournamentSearch, avatars, responses, this);
+    adminServer = new AdminServer([this]() { return prometheusMetrics(); }, this);
+    adminPort = 0;
+
+    startingMessage = QSharedPointer<StartingMessage>(new StartingMessage());
+    startingMessageWatcher = new QFileSystemWatcher(this);
+    connect(startingMessageWatcher, &QFileSystemWatcher::fileChanged, this, &TcpServer::reloadStartingMessage);
+    connect(startingMessageWatcher, &QFileSystemWatcher::directoryChanged, this, &TcpServer::reloadStartingMessage);
 }
 
 bool TcpServer::startServer(quint16 port, const QHostAddress & address)
 {
-    if(!QTcpServer::listen(address, port))
+    qintptr sharedDescriptor = sharedAccept ? PoolAcceptor::openSharedSocket(address, port) : -1;
+
+    if(sharedDescriptor != -1)
+    {
+        if(!setSocketDescriptor(sharedDescriptor))
+            return false;
+    }
+    else if(!QTcpServer::listen(address, port))
         return false;
 
-    for(int i=0; i<QThreadPool::globalInstance()->maxThreadCount(); i++)
+    leaderboards->rebuild(databaseName);
+    tournamentSearch->rebuild(databaseName);
+    reloadStartingMessage();
+
+    workerPool->setDatabaseName(databaseName);
+    workerPool->setNumberOfWorkers(numberOfDbWorkers);
+    workerPool->start();
+
+    for(int i=0; i<numberOfConnectionPools; i++)
         createConnectionPool();
 
+    // Each pool accepts on its own socket bound to the same port, this listener keeps only its kernel-assigned share.
+    if(sharedDescriptor != -1)
+    {
+        for(auto pool : connectionPools)
+            pool->listenShared(address, serverPort());
+    }
+
+    if(adminPort != 0 && !adminServer->start(adminPort))
+        qWarning("Couldn't start the admin endpoint on port %d.", adminPort);
+
     emit started();
 
     return true;
@@ -23,6 +62,9 @@ void TcpServer::closeServer()
     if(!isListening())
         return;
 
+    workerPool->stop();
+    adminServer->close();
+
     emit quit();
     close();
 
@@ -31,7 +73,7 @@ void TcpServer::closeServer()
 
 void TcpServer::createConnectionPool()
 {
-    TcpConnectionsWrapper * pool = new TcpConnectionsWrapper(this);
+    TcpConnectionsWrapper * pool = new TcpConnectionsWrapper(workerPool, startingMessage, this);
     connectionPools.append(pool);
 
     connect(this, &TcpServer::quit, pool, &TcpConnectionsWrapper::close);
@@ -43,25 +85,43 @@ void TcpServer::createConnectionPool()
     connect(pool, &TcpConnectionsWrapper::clientsDecreased, this, &TcpServer::poolUpdated);
 }
 
+void TcpServer::reloadStartingMessage()
+{
+    QString path = startingMessage->getPath();
+    QString directory = QFileInfo(path).absolutePath();
+
+    startingMessage->reload();
+
+    // Editors often replace the file instead of writing into it, which drops it from the watcher,
+    // so the directory is watched too and the file is added back once it exists again.
+    if(!startingMessageWatcher->directories().contains(directory) && QFileInfo::exists(directory))
+        startingMessageWatcher->addPath(directory);
+
+    if(!startingMessageWatcher->files().contains(path) && QFileInfo::exists(path))
+        startingMessageWatcher->addPath(path);
+}
+
 void TcpServer::incomingConnection(qintptr descriptor)
 {
     if(connectionPools.count() == 0)
         return;
 
     TcpConnectionsWrapper * selectedPool = nullptr;
+    int selectedScore = 0;
 
     for(auto pool : connectionPools)
     {
-        if(!selectedPool)
+        int score = pool->getLoad()->score();
+
+        if(!selectedPool || score < selectedScore)
         {
             selectedPool = pool;
-            continue;
+            selectedScore = score;
         }
-
-        if(pool->getNumberOfConnections() < selectedPool->getNumberOfConnections())
-            selectedPool = pool;
     }
 
+    // Counted right away, so a burst of accepts sees each placement before the pool thread gets to it.
+    selectedPool->getLoad()->connectionAccepted();
     emit connectionPending(descriptor, selectedPool);
 }
 
@@ -97,6 +157,52 @@ QString TcpServer::lastError() const
     return errorString();
 }
 
+QString TcpServer::metricsReport() const
+{
+    return ServerMetrics::report();
+}
+
+QString TcpServer::prometheusMetrics() const
+{
+    QString text("# TYPE scorepredictor_pool_connections gauge\n");
+
+    for(int i=0; i<connectionPools.size(); i++)
+        text += QString("scorepredictor_pool_connections{pool=\"%1\"} %2\n").arg(i)
+                .arg(connectionPools[i]->getLoad()->getConnections());
+
+    text += "# TYPE scorepredictor_pool_pending_requests gauge\n";
+
+    for(int i=0; i<connectionPools.size(); i++)
+        text += QString("scorepredictor_pool_pending_requests{pool=\"%1\"} %2\n").arg(i)
+                .arg(connectionPools[i]->getLoad()->getPendingRequests());
+
+    text += "# TYPE scorepredictor_pool_busy_ratio gauge\n";
+
+    for(int i=0; i<connectionPools.size(); i++)
+        text += QString("scorepredictor_pool_busy_ratio{pool=\"%1\"} %2\n").arg(i)
+                .arg(connectionPools[i]->getLoad()->getBusyPermille() / 1000.0);
+
+    LatencyHistogram databaseLatency;
+    ServerMetrics::mergeStage(ServerMetrics::STAGE_DATABASE, databaseLatency);
+
+    text += QString("# TYPE scorepredictor_db_queue_depth gauge\nscorepredictor_db_queue_depth %1\n")
+            .arg(workerPool->getQueueDepth());
+    text += QString("# TYPE scorepredictor_statement_cache_hits_total counter\n"
+                    "scorepredictor_statement_cache_hits_total %1\n").arg(DbConnection::getTotalStatementCacheHits());
+    text += QString("# TYPE scorepredictor_statement_cache_misses_total counter\n"
+                    "scorepredictor_statement_cache_misses_total %1\n").arg(DbConnection::getTotalStatementCacheMisses());
+    text += "# TYPE scorepredictor_db_latency_seconds summary\n";
+
+    for(double quantile : {0.5, 0.99, 0.999})
+        text += QString("scorepredictor_db_latency_seconds{quantile=\"%1\"} %2\n").arg(quantile)
+                .arg(databaseLatency.percentile(quantile) / 1000000.0);
+
+    text += QString("scorepredictor_db_latency_seconds_sum %1\nscorepredictor_db_latency_seconds_count %2\n")
+            .arg(databaseLatency.getSum() / 1000000.0).arg(databaseLatency.getCount());
+
+    return text + ServerMetrics::prometheusText();
+}
+
 int TcpServer::numberOfClients() const
 {
     int totalNumberOfClients = 0;
@@ -106,3 +212,43 @@ int TcpServer::numberOfClients() const
 
     return totalNumberOfClients;
 }
+
+void TcpServer::setNumberOfConnectionPools(int value)
+{
+    if(isListening() || value < 1)
+        return;
+
+    numberOfConnectionPools = value;
+}
+
+void TcpServer::setNumberOfDbWorkers(int value)
+{
+    if(isListening() || value < 1)
+        return;
+
+    numberOfDbWorkers = value;
+}
+
+void TcpServer::setSharedAccept(bool value)
+{
+    if(isListening())
+        return;
+
+    sharedAccept = value;
+}
+
+void TcpServer::setAdminPort(quint16 value)
+{
+    if(isListening())
+        return;
+
+    adminPort = value;
+}
+
+void TcpServer::setDatabaseName(const QString & value)
+{
+    if(isListening())
+        return;
+
+    databaseName = value;
+}
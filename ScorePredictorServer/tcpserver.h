@@ -4,7 +4,18 @@
 #include <QTcpServer>
 #include <QThreadPool>
 #include <QTimer>
+#include <QFileSystemWatcher>
+#include <QFileInfo>
 #include <tcpconnectionswrapper.h>
+#include <leaderboardengine.h>
+#include <tournamentsearchindex.h>
+#include <avatarstore.h>
+#include <startingmessage.h>
+#include <responsecache.h>
+#include <dbworkerpool.h>
+#include <poolacceptor.h>
+#include <servermetrics.h>
+#include <adminserver.h>
 
 class TcpServer : public QTcpServer
 {
@@ -12,6 +23,22 @@ class TcpServer : public QTcpServer
 
 private:
     QList<TcpConnectionsWrapper *> connectionPools;
+    int numberOfConnectionPools;
+    int numberOfDbWorkers;
+    bool sharedAccept;
+    AdminServer * adminServer;
+    quint16 adminPort;
+    DbWorkerPool * workerPool;
+    QString databaseName;
+    QSharedPointer<LeaderboardEngine> leaderboards;
+    QSharedPointer<TournamentSearchIndex> tournamentSearch;
+    QSharedPointer<AvatarStore> avatars;
+    QSharedPointer<ResponseCache> responses;
+    QSharedPointer<StartingMessage> startingMessage;
+    QFileSystemWatcher * startingMessageWatcher;
+
+private slots:
+    void reloadStartingMessage();
 
 protected:
     void incomingConnection(qintptr descriptor);
@@ -25,10 +52,18 @@ public:
     Q_INVOKABLE void closeServer();
     Q_INVOKABLE bool isSafeToTerminate();
     Q_INVOKABLE QString lastError() const;
+    Q_INVOKABLE QString metricsReport() const;
+    QString prometheusMetrics() const;
 
     int numberOfClients() const;
     qint64 port() const;
 
+    void setNumberOfConnectionPools(int value);
+    void setNumberOfDbWorkers(int value);
+    void setSharedAccept(bool value);
+    void setAdminPort(quint16 value);
+    void setDatabaseName(const QString & value);
+
 public slots:
     void poolFinished();
     void poolUpdated();
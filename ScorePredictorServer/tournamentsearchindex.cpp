@@ -0,0 +1,279 @@
+#include "tournamentsearchindex.h"
+#include <query.h>
+#include <algorithm>
+
+const QString TournamentSearchIndex::LOADING_CONNECTION_NAME = QString("TournamentSearchLoading");
+const int TournamentSearchIndex::ORDERED_SCAN_THRESHOLD = 20000;
+
+TournamentSearchIndex::TournamentSearchIndex()
+{
+    ready = false;
+}
+
+bool TournamentSearchIndex::rebuild(const QString & databaseName)
+{
+    QSharedPointer<DbConnection> connection(new DbConnection);
+    QHash<unsigned int, TournamentSearchEntry> entries;
+    QHash<unsigned int, QSet<unsigned int> > participants;
+
+    if(databaseName.isEmpty() ? !connection->connect(LOADING_CONNECTION_NAME) :
+                                !connection->connect(LOADING_CONNECTION_NAME, databaseName))
+        return false;
+
+    {
+        Query query(connection);
+        query.findAllSearchableTournaments();
+
+        while(query.next())
+        {
+            unsigned int tournamentId = query.value("id").toUInt();
+            entries.insert(tournamentId, createEntry(tournamentId, query.value("name").toString(),
+                                                     query.value("host_name").toString(),
+                                                     query.value("password_required").toBool(),
+                                                     query.value("entries_end_time").toDateTime(),
+                                                     query.value("predictors_limit").toUInt()));
+        }
+
+        query.findAllTournamentsParticipants();
+
+        while(query.next())
+        {
+            unsigned int tournamentId = query.value("tournament_id").toUInt();
+
+            if(entries.contains(tournamentId))
+                entries[tournamentId].predictors++;
+
+            participants[query.value("user_id").toUInt()].insert(tournamentId);
+        }
+    }
+
+    connection->close();
+
+    QWriteLocker locker(&lock);
+    tournaments.clear();
+    tournamentsByEndTime.clear();
+    trigrams.clear();
+    joinedTournaments = participants;
+
+    // Posting lists are sorted once at the end instead of on every insertion.
+    for(auto entry : entries)
+        insert(entry, false);
+
+    for(auto it = trigrams.begin(); it != trigrams.end(); ++it)
+        std::sort(it.value().begin(), it.value().end());
+
+    ready = true;
+    return true;
+}
+
+bool TournamentSearchIndex::isReady() const
+{
+    QReadLocker locker(&lock);
+    return ready;
+}
+
+void TournamentSearchIndex::addTournament(const TournamentSearchEntry & entry)
+{
+    QWriteLocker locker(&lock);
+
+    if(!ready || tournaments.contains(entry.id))
+        return;
+
+    insert(entry, true);
+}
+
+void TournamentSearchIndex::addParticipant(unsigned int tournamentId, unsigned int userId)
+{
+    QWriteLocker locker(&lock);
+
+    if(!ready || joinedTournaments[userId].contains(tournamentId))
+        return;
+
+    joinedTournaments[userId].insert(tournamentId);
+
+    if(tournaments.contains(tournamentId))
+        tournaments[tournamentId].entry.predictors++;
+}
+
+void TournamentSearchIndex::insert(const TournamentSearchEntry & entry, bool keepSorted)
+{
+    IndexedTournament tournament;
+    tournament.entry = entry;
+    tournament.foldedName = entry.name.toLower();
+    tournament.endTime = entry.entriesEndTime.toMSecsSinceEpoch();
+
+    tournaments.insert(entry.id, tournament);
+    tournamentsByEndTime.insert(tournament.endTime, entry.id);
+
+    for(auto trigram : findTrigrams(tournament.foldedName))
+    {
+        QVector<unsigned int> & ids = trigrams[trigram];
+
+        if(keepSorted)
+            ids.insert(std::lower_bound(ids.begin(), ids.end(), entry.id), entry.id);
+        else
+            ids.append(entry.id);
+    }
+}
+
+QVector<TournamentSearchEntry> TournamentSearchIndex::find(unsigned int userId, const QDateTime & dateTime,
+                                                           int itemsLimit, const QString & tournamentName) const
+{
+    QVector<TournamentSearchEntry> result;
+    QStringList tokens = tokenize(tournamentName);
+    QVector<quint64> queryTrigrams;
+    qint64 minEndTime = dateTime.toMSecsSinceEpoch();
+
+    for(auto token : tokens)
+    {
+        for(auto trigram : findTrigrams(token))
+        {
+            if(!queryTrigrams.contains(trigram))
+                queryTrigrams << trigram;
+        }
+    }
+
+    if(itemsLimit <= 0)
+        return result;
+
+    QReadLocker locker(&lock);
+    QSet<unsigned int> joined = joinedTournaments.value(userId);
+    QVector<unsigned int> candidates;
+
+    // The shortest posting list is intersected with the others, so rare trigrams keep the work small.
+    if(!queryTrigrams.isEmpty())
+    {
+        QVector<const QVector<unsigned int> *> postingLists;
+
+        for(auto trigram : queryTrigrams)
+        {
+            auto it = trigrams.constFind(trigram);
+
+            if(it == trigrams.constEnd())
+                return result;
+
+            postingLists << &it.value();
+        }
+
+        std::sort(postingLists.begin(), postingLists.end(),
+                  [](const QVector<unsigned int> * first, const QVector<unsigned int> * second) {
+            return first->size() < second->size();
+        });
+
+        candidates = *postingLists.first();
+
+        for(int i=1; i<postingLists.size() && !candidates.isEmpty(); i++)
+        {
+            QVector<unsigned int> intersection;
+            std::set_intersection(candidates.constBegin(), candidates.constEnd(), postingLists[i]->constBegin(),
+                                  postingLists[i]->constEnd(), std::back_inserter(intersection));
+            candidates = intersection;
+        }
+    }
+
+    if(!queryTrigrams.isEmpty() && candidates.size() <= ORDERED_SCAN_THRESHOLD)
+    {
+        QVector<const IndexedTournament *> listed;
+
+        for(auto id : candidates)
+        {
+            const IndexedTournament & tournament = *tournaments.constFind(id);
+
+            if(tournament.endTime > minEndTime && isListed(tournament, joined, tokens))
+                listed << &tournament;
+        }
+
+        int count = qMin(itemsLimit, listed.size());
+        std::partial_sort(listed.begin(), listed.begin() + count, listed.end(),
+                          [](const IndexedTournament * first, const IndexedTournament * second) {
+            return first->endTime < second->endTime ||
+                   (first->endTime == second->endTime && first->entry.id < second->entry.id);
+        });
+
+        for(int i=0; i<count; i++)
+            result << listed[i]->entry;
+
+        return result;
+    }
+
+    // Without selective trigrams the tournaments are walked in entries end time order until the page is full.
+    for(auto it = tournamentsByEndTime.upperBound(minEndTime); it != tournamentsByEndTime.constEnd(); ++it)
+    {
+        if(!queryTrigrams.isEmpty() && !std::binary_search(candidates.constBegin(), candidates.constEnd(), it.value()))
+            continue;
+
+        const IndexedTournament & tournament = *tournaments.constFind(it.value());
+
+        if(!isListed(tournament, joined, tokens))
+            continue;
+
+        result << tournament.entry;
+
+        if(result.size() >= itemsLimit)
+            break;
+    }
+
+    return result;
+}
+
+// Mirrors findTournaments: someone has already joined, the user hasn't and the words appear in order.
+bool TournamentSearchIndex::isListed(const IndexedTournament & tournament, const QSet<unsigned int> & joined,
+                                     const QStringList & tokens) const
+{
+    return tournament.entry.predictors > 0 && !joined.contains(tournament.entry.id) &&
+           matchesTokens(tournament.foldedName, tokens);
+}
+
+QStringList TournamentSearchIndex::tokenize(const QString & text)
+{
+    return text.toLower().split(' ', QString::SkipEmptyParts);
+}
+
+QVector<quint64> TournamentSearchIndex::findTrigrams(const QString & foldedText)
+{
+    QVector<quint64> result;
+
+    for(int i=0; i+2<foldedText.size(); i++)
+    {
+        quint64 trigram = (quint64(foldedText[i].unicode()) << 32) | (quint64(foldedText[i + 1].unicode()) << 16) |
+                          quint64(foldedText[i + 2].unicode());
+
+        if(!result.contains(trigram))
+            result << trigram;
+    }
+
+    return result;
+}
+
+bool TournamentSearchIndex::matchesTokens(const QString & foldedName, const QStringList & tokens)
+{
+    int position = 0;
+
+    for(auto token : tokens)
+    {
+        position = foldedName.indexOf(token, position);
+
+        if(position < 0)
+            return false;
+
+        position += token.size();
+    }
+
+    return true;
+}
+
+TournamentSearchEntry TournamentSearchIndex::createEntry(unsigned int id, const QString & name, const QString & hostName,
+                                                         bool passwordRequired, const QDateTime & entriesEndTime,
+                                                         unsigned int predictorsLimit)
+{
+    TournamentSearchEntry entry;
+    entry.id = id;
+    entry.name = name;
+    entry.hostName = hostName;
+    entry.passwordRequired = passwordRequired;
+    entry.entriesEndTime = entriesEndTime;
+    entry.predictors = 0;
+    entry.predictorsLimit = predictorsLimit;
+
+    return entry;
+}
@@ -0,0 +1,69 @@
+#ifndef TOURNAMENTSEARCHINDEX_H
+#define TOURNAMENTSEARCHINDEX_H
+
+#include <QHash>
+#include <QMultiMap>
+#include <QSet>
+#include <QVector>
+#include <QDateTime>
+#include <QReadWriteLock>
+#include <dbconnection.h>
+
+struct TournamentSearchEntry
+{
+    unsigned int id;
+    QString name;
+    QString hostName;
+    bool passwordRequired;
+    QDateTime entriesEndTime;
+    unsigned int predictors;
+    unsigned int predictorsLimit;
+};
+
+class TournamentSearchIndex
+{
+private:
+    struct IndexedTournament
+    {
+        TournamentSearchEntry entry;
+        QString foldedName;
+        qint64 endTime;
+    };
+
+    QHash<unsigned int, IndexedTournament> tournaments;
+    QMultiMap<qint64, unsigned int> tournamentsByEndTime;
+    QHash<quint64, QVector<unsigned int> > trigrams;
+    QHash<unsigned int, QSet<unsigned int> > joinedTournaments;
+    bool ready;
+    mutable QReadWriteLock lock;
+
+    const static QString LOADING_CONNECTION_NAME;
+    const static int ORDERED_SCAN_THRESHOLD;
+
+    void insert(const TournamentSearchEntry & entry, bool keepSorted);
+    bool isListed(const IndexedTournament & tournament, const QSet<unsigned int> & joined,
+                  const QStringList & tokens) const;
+
+    static QStringList tokenize(const QString & text);
+    static QVector<quint64> findTrigrams(const QString & foldedText);
+    static bool matchesTokens(const QString & foldedName, const QStringList & tokens);
+
+public:
+    TournamentSearchIndex();
+    ~TournamentSearchIndex() {}
+
+    bool rebuild(const QString & databaseName = QString());
+    bool isReady() const;
+
+    void addTournament(const TournamentSearchEntry & entry);
+    void addParticipant(unsigned int tournamentId, unsigned int userId);
+
+    QVector<TournamentSearchEntry> find(unsigned int userId, const QDateTime & dateTime, int itemsLimit,
+                                        const QString & tournamentName) const;
+
+    static TournamentSearchEntry createEntry(unsigned int id, const QString & name, const QString & hostName,
+                                             bool passwordRequired, const QDateTime & entriesEndTime,
+                                             unsigned int predictorsLimit);
+};
+
+#endif // TOURNAMENTSEARCHINDEX_H
@@ -0,0 +1,70 @@
+QT += network sql
+QT -= quick
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# The following define makes your compiler emit warnings if you use
+# any feature of Qt which as been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# The server sources include each other with angle brackets.
+INCLUDEPATH += ../ScorePredictorServer
+
+SOURCES += main.cpp \
+    ../ScorePredictorServer/tcpserver.cpp \
+    ../ScorePredictorServer/tcpconnection.cpp \
+    ../ScorePredictorServer/tcpconnections.cpp \
+    ../ScorePredictorServer/dbconnection.cpp \
+    ../ScorePredictorServer/tcpconnectionswrapper.cpp \
+    ../ScorePredictorServer/packet.cpp \
+    ../ScorePredictorServer/packetbuffer.cpp \
+    ../ScorePredictorServer/query.cpp \
+    ../ScorePredictorServer/packetprocessor.cpp \
+    ../ScorePredictorServer/leaderboardengine.cpp \
+    ../ScorePredictorServer/replychannel.cpp \
+    ../ScorePredictorServer/dbworker.cpp \
+    ../ScorePredictorServer/dbworkerpool.cpp \
+    ../ScorePredictorServer/connectionsload.cpp \
+    ../ScorePredictorServer/poolacceptor.cpp \
+    ../ScorePredictorServer/latencyhistogram.cpp \
+    ../ScorePredictorServer/servermetrics.cpp \
+    ../ScorePredictorServer/adminserver.cpp \
+    ../ScorePredictorServer/tournamentsearchindex.cpp \
+    ../ScorePredictorServer/avatarstore.cpp \
+    ../ScorePredictorServer/startingmessage.cpp \
+    ../ScorePredictorServer/responsecache.cpp \
+    ../ScorePredictorClient/tournament.cpp \
+    ../ScorePredictorClient/match.cpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+HEADERS += \
+    ../ScorePredictorServer/tcpserver.h \
+    ../ScorePredictorServer/tcpconnection.h \
+    ../ScorePredictorServer/tcpconnections.h \
+    ../ScorePredictorServer/dbconnection.h \
+    ../ScorePredictorServer/tcpconnectionswrapper.h \
+    ../ScorePredictorServer/packet.h \
+    ../ScorePredictorServer/packetbuffer.h \
+    ../ScorePredictorServer/query.h \
+    ../ScorePredictorServer/packetprocessor.h \
+    ../ScorePredictorServer/leaderboardengine.h \
+    ../ScorePredictorServer/replychannel.h \
+    ../ScorePredictorServer/dbworker.h \
+    ../ScorePredictorServer/dbworkerpool.h \
+    ../ScorePredictorServer/connectionsload.h \
+    ../ScorePredictorServer/poolacceptor.h \
+    ../ScorePredictorServer/latencyhistogram.h \
+    ../ScorePredictorServer/servermetrics.h \
+    ../ScorePredictorServer/adminserver.h \
+    ../ScorePredictorServer/tournamentsearchindex.h \
+    ../ScorePredictorServer/avatarstore.h \
+    ../ScorePredictorServer/startingmessage.h \
+    ../ScorePredictorServer/responsecache.h \
+    ../ScorePredictorClient/tournament.h \
+    ../ScorePredictorClient/match.h
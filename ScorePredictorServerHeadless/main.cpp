@@ -0,0 +1,149 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <csignal>
+#include <tcpserver.h>
+
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#endif
+
+namespace
+{
+#ifdef Q_OS_UNIX
+    int signalSockets[2] = {-1, -1};
+
+    // Only write() is async-signal-safe here, the signal itself is handled by the event loop reading the other end.
+    void handleSignal(int signal)
+    {
+        int savedErrno = errno;
+        char signalNumber = char(signal);
+
+        ssize_t written = ::write(signalSockets[0], &signalNumber, sizeof(signalNumber));
+        Q_UNUSED(written)
+
+        errno = savedErrno;
+    }
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ScorePredictorServerHeadless");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("ScorePredictor server without the graphical interface.");
+    parser.addHelpOption();
+
+    QCommandLineOption portOption(QStringList() << "p" << "port", "Port to listen on.", "port", "1024");
+    QCommandLineOption threadsOption(QStringList() << "t" << "threads",
+                                     "Number of connection pools (worker threads).", "threads",
+                                     QString::number(QThread::idealThreadCount()));
+    QCommandLineOption dbWorkersOption(QStringList() << "j" << "db-workers",
+                                       "Number of threads running database requests.", "workers",
+                                       QString::number(QThread::idealThreadCount()));
+    QCommandLineOption reusePortOption(QStringList() << "r" << "reuse-port",
+                                       "Let every connection pool accept on its own SO_REUSEPORT socket.");
+    QCommandLineOption adminPortOption(QStringList() << "m" << "admin-port",
+                                       "Serve Prometheus metrics on 127.0.0.1 at this port, 0 disables it.",
+                                       "port", "0");
+    QCommandLineOption databaseOption(QStringList() << "d" << "database", "Path to the SQLite database.",
+                                      "database", "data/database.db");
+    QCommandLineOption directoryOption(QStringList() << "w" << "working-directory",
+                                       "Directory containing data/ and avatars/.", "directory");
+    parser.addOption(portOption);
+    parser.addOption(threadsOption);
+    parser.addOption(dbWorkersOption);
+    parser.addOption(reusePortOption);
+    parser.addOption(adminPortOption);
+    parser.addOption(databaseOption);
+    parser.addOption(directoryOption);
+    parser.process(app);
+
+    if(parser.isSet(directoryOption) && !QDir::setCurrent(parser.value(directoryOption)))
+    {
+        qCritical("Couldn't change the working directory to %s", qPrintable(parser.value(directoryOption)));
+        return -1;
+    }
+
+    bool portOk = false;
+    bool threadsOk = false;
+    bool dbWorkersOk = false;
+    bool adminPortOk = false;
+    quint16 port = parser.value(portOption).toUShort(&portOk);
+    int threads = parser.value(threadsOption).toInt(&threadsOk);
+    int dbWorkers = parser.value(dbWorkersOption).toInt(&dbWorkersOk);
+    quint16 adminPort = parser.value(adminPortOption).toUShort(&adminPortOk);
+
+    if(!portOk || !threadsOk || !dbWorkersOk || !adminPortOk || threads < 1 || dbWorkers < 1)
+    {
+        qCritical("Invalid port or number of threads.");
+        return -1;
+    }
+
+    QScopedPointer<TcpServer> server(new TcpServer);
+    server->setNumberOfConnectionPools(threads);
+    server->setNumberOfDbWorkers(dbWorkers);
+    server->setSharedAccept(parser.isSet(reusePortOption));
+    server->setAdminPort(adminPort);
+    server->setDatabaseName(parser.value(databaseOption));
+
+    QObject::connect(server.data(), &TcpServer::finished, &app, &QCoreApplication::quit);
+    QObject::connect(server.data(), &TcpServer::closed, [&server]() {
+        if(server->isSafeToTerminate())
+            QCoreApplication::quit();
+    });
+
+    if(!server->startServer(port))
+    {
+        qCritical("The following error occured: %s", qPrintable(server->lastError()));
+        return -1;
+    }
+
+    qInfo("Listening on port %d with %d connection pools and %d database workers.", port, threads, dbWorkers);
+
+#ifdef Q_OS_UNIX
+    if(::socketpair(AF_UNIX, SOCK_STREAM, 0, signalSockets) != 0)
+    {
+        qCritical("Couldn't create the signal socket pair.");
+        return -1;
+    }
+
+    // A full socket must not block the signal handler, a dropped byte only repeats a pending request.
+    ::fcntl(signalSockets[0], F_SETFL, ::fcntl(signalSockets[0], F_GETFL) | O_NONBLOCK);
+
+    QSocketNotifier signalNotifier(signalSockets[1], QSocketNotifier::Read);
+    QObject::connect(&signalNotifier, &QSocketNotifier::activated, [&server]() {
+        char signalNumber = 0;
+
+        if(::read(signalSockets[1], &signalNumber, sizeof(signalNumber)) != sizeof(signalNumber))
+            return;
+
+        if(signalNumber == SIGUSR1)
+            qInfo("%s", qPrintable(server->metricsReport()));
+        else
+            server->closeServer();
+    });
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::signal(SIGUSR1, handleSignal);
+#endif
+
+    int result = app.exec();
+
+#ifdef Q_OS_UNIX
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGUSR1, SIG_DFL);
+    ::close(signalSockets[0]);
+    ::close(signalSockets[1]);
+#endif
+
+    return result;
+}